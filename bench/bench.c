@@ -0,0 +1,631 @@
+// EXPLANATION:
+// Benchmarks for the simulation's hot paths, built on the headless platform
+// Each case builds a synthetic world, then times one part of the game tick
+// over many ticks and reports ns/tick, ns/entity and allocations per tick
+//
+// Usage: asteroids_bench [--rocks N] [--missiles N] [--threads N] [--filter NAME] [--json FILE] [--label TEXT] [--replay FILE] [--scaling]
+// The JSON file is meant to be kept per commit and diffed to catch regressions
+// --replay times a recorded session tick by tick instead, to track down a reported slowdown
+// --threads runs the cases on N threads (see jobs.h), 1 by default so results compare across machines
+// The narrow-phase cases test a few missiles against every rock, scalar and with
+// the circle kernel, build with -mavx2 (e.g. make asteroids_bench CC="gcc -mavx2")
+// or for the web to time the other instruction sets (see kernels.h)
+// --scaling times UpdateGameTick on a big world at 1, 2, 4... threads up to the core
+// count (or --threads), and checks every thread count ends up with the same game
+
+#include "../code/asteroids.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../code/config.h"
+#include "../code/allocator.h"
+#include "../code/jobs.h"
+#include "../code/kernels.h"
+#include "../code/replay.h"
+#include "../code/snapshot.h"
+
+#define BENCH_TICKS_PER_BATCH 16   // ticks timed between world rebuilds
+#define BENCH_MIN_TIME 0.05        // seconds spent timing each case, at least...
+#define BENCH_MIN_BATCHES 5        // ...and at least this many batches
+#define BENCH_MAX_TIME 1.0         // seconds per case including world rebuilds, stops early for big worlds
+#define BENCH_MAX_RESULTS 256
+#define BENCH_SEED 1234
+#define BENCH_PAIR_MISSILES 8 // missiles tested against every rock in the narrow-phase cases
+#define BENCH_SCALING_ROCKS 100000  // world for --scaling, unless --rocks/--missiles say otherwise
+#define BENCH_SCALING_MISSILES 1000
+#define BENCH_SCALING_CHECK_TICKS 240 // ticks run before comparing the game across thread counts
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+
+typedef enum BenchLayout {
+    LAYOUT_INTERIOR, // nothing touches the screen edges
+    LAYOUT_EDGE,     // everything straddles a screen edge and slides along it
+} BenchLayout;
+
+typedef struct BenchWorld {
+    unsigned int rockCount;
+    unsigned int missileCount;
+    BenchLayout layout;
+} BenchWorld;
+
+typedef struct BenchCase {
+    const char *name;
+    void (*RunTick)(void);
+    unsigned int (*GetEntityCount)(const BenchWorld *world); // what ns/entity divides by
+    bool rebuildEachTick; // for cases that change the world on their first tick
+    bool reportsBytes; // snapshot cases, the size of benchSnapshot is reported too
+} BenchCase;
+
+typedef struct BenchResult {
+    const char *name;
+    BenchWorld world;
+    unsigned int threadCount;
+    unsigned long long ticks;
+    double nsPerTick;
+    double nsPerEntity;
+    double allocsPerTick;
+    unsigned int bytes; // 0 unless the case reportsBytes
+} BenchResult;
+
+// Globals
+// ----------------------------------------------------------------------------
+GameState game; // game data
+SpaceShip savedShip; // ship as placed by BuildWorld
+RandomStream benchRandom; // world layouts, reseeded for every build
+Snapshot benchSnapshot; // of the world as BuildWorld left it
+Snapshot scalingSnapshot; // of the scaling world after its check ticks, on one thread
+volatile unsigned int benchSink; // keeps results the compiler would otherwise drop
+
+BenchResult results[BENCH_MAX_RESULTS];
+unsigned int resultCount = 0;
+
+// Local Functions Declaration
+// ----------------------------------------------------------------------------
+void BuildWorld(const BenchWorld *world); // Replace the game's pools with a synthetic world
+Vector2 GetLayoutPosition(BenchLayout layout, float margin, float *angle);
+BenchResult RunBenchCase(const BenchCase *bench, const BenchWorld *world);
+BenchResult RunReplay(void); // Every tick of the loaded replay, once
+void RunScaling(const BenchWorld *world, unsigned int maxThreads); // UpdateGameTick on 1, 2, 4... threads
+bool CheckScalingSnapshot(const BenchWorld *world, bool isReference); // Same game as on one thread
+int CompareDoubles(const void *a, const void *b);
+void WriteResultsJson(const char *path, const char *label);
+
+void RunUpdateAsteroids(void);
+void RunUpdateMissiles(void);
+void RunUpdateShip(void);
+void RunCheckCollisionAsteroidShip(void);
+void RunCheckCollisionMissilesAsteroids(void);
+void RunUpdateGameTick(void);
+void RunSaveSnapshot(void);
+void RunCircleTestScalar(void);
+void RunCheckCirclesToroidal(void);
+void RunCheckCirclesToroidalIndexed(void);
+void RunRestoreSnapshot(void);
+
+unsigned int GetRockCount(const BenchWorld *world);
+unsigned int GetMissileCount(const BenchWorld *world);
+unsigned int GetShipCount(const BenchWorld *world);
+unsigned int GetEntityCount(const BenchWorld *world);
+unsigned int GetPairCount(const BenchWorld *world);
+unsigned int CountHits(unsigned int hits);
+
+static const BenchCase benchCases[] = {
+    { "UpdateAsteroids", RunUpdateAsteroids, GetRockCount, false, false },
+    { "UpdateMissiles", RunUpdateMissiles, GetMissileCount, false, false },
+    { "UpdateShip", RunUpdateShip, GetShipCount, false, false },
+    { "CheckCollisionAsteroidShip", RunCheckCollisionAsteroidShip, GetRockCount, false, false },
+    { "CheckCollisionMissilesAsteroids", RunCheckCollisionMissilesAsteroids, GetMissileCount, true, false },
+    { "CircleTestScalar", RunCircleTestScalar, GetPairCount, false, false },
+    { "CheckCirclesToroidal", RunCheckCirclesToroidal, GetPairCount, false, false },
+    { "CheckCirclesToroidalIndexed", RunCheckCirclesToroidalIndexed, GetPairCount, false, false },
+    { "UpdateGameTick", RunUpdateGameTick, GetEntityCount, false, false },
+    { "SaveSnapshot", RunSaveSnapshot, GetEntityCount, false, true },
+    { "RestoreSnapshot", RunRestoreSnapshot, GetEntityCount, false, true },
+};
+
+// A full missile load at game scale, then a stress load for the big worlds
+static const BenchWorld benchWorlds[] = {
+    { .rockCount = 4, .missileCount = MISSILE_MAX },
+    { .rockCount = 64, .missileCount = MISSILE_MAX },
+    { .rockCount = 1000, .missileCount = MISSILE_MAX },
+    { .rockCount = 10000, .missileCount = 1000 },
+    { .rockCount = 100000, .missileCount = 1000 },
+};
+
+int main(int argc, char **argv)
+{
+    unsigned int rockCount = 0;
+    unsigned int missileCount = 0;
+    const char *filter = 0;
+    const char *jsonPath = 0;
+    const char *label = "";
+    const char *replayPath = 0;
+    unsigned int threadCount = 1;
+    bool scaling = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--rocks") == 0 && i + 1 < argc)
+            rockCount = (unsigned int)strtoul(argv[++i], 0, 10);
+        else if (strcmp(argv[i], "--missiles") == 0 && i + 1 < argc)
+            missileCount = (unsigned int)strtoul(argv[++i], 0, 10);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threadCount = (unsigned int)strtoul(argv[++i], 0, 10);
+        else if (strcmp(argv[i], "--scaling") == 0)
+            scaling = true;
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            jsonPath = argv[++i];
+        else if (strcmp(argv[i], "--label") == 0 && i + 1 < argc)
+            label = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            replayPath = argv[++i];
+        else
+        {
+            fprintf(stderr, "Usage: %s [--rocks N] [--missiles N] [--threads N] [--filter NAME] [--json FILE] [--label TEXT] [--replay FILE] [--scaling]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    SetTraceLogLevel(LOG_ERROR); // a full pool warns on every dropped split
+    if (scaling)
+    {
+        BenchWorld world = {
+            .rockCount = (rockCount > 0)? rockCount : BENCH_SCALING_ROCKS,
+            .missileCount = (missileCount > 0)? missileCount : BENCH_SCALING_MISSILES,
+        };
+        InitGameState(BENCH_SEED);
+        game.currentScreen = SCREEN_GAMEPLAY;
+        RunScaling(&world, (threadCount > 1)? threadCount : GetCpuCount());
+        if (jsonPath) WriteResultsJson(jsonPath, label);
+        FreeSnapshot(&scalingSnapshot);
+        FreeSnapshot(&benchSnapshot);
+        FreeGameState();
+        return 0;
+    }
+
+    InitJobSystem(threadCount);
+    if (replayPath)
+    {
+        if (!LoadReplay(replayPath)) return 1;
+        results[resultCount++] = RunReplay();
+        if (jsonPath) WriteResultsJson(jsonPath, label);
+        FreeReplay();
+        FreeJobSystem();
+        return 0;
+    }
+
+    InitGameState(BENCH_SEED);
+    game.currentScreen = SCREEN_GAMEPLAY;
+
+    printf("kernels: %s, threads: %u\n", GetKernelInstructionSet(), jobs.threadCount);
+    printf("%-32s %-8s %7s %9s %14s %12s %12s %12s\n",
+           "case", "layout", "rocks", "missiles", "ns/tick", "ns/entity", "allocs/tick", "bytes");
+
+    unsigned int worldCount = sizeof(benchWorlds)/sizeof(benchWorlds[0]);
+    unsigned int caseCount = sizeof(benchCases)/sizeof(benchCases[0]);
+    for (unsigned int w = 0; w < worldCount; w++)
+    {
+        for (BenchLayout layout = LAYOUT_INTERIOR; layout <= LAYOUT_EDGE; layout++)
+        {
+            BenchWorld world = benchWorlds[w];
+            world.layout = layout;
+            if (rockCount > 0)
+            {
+                // Only run the one world asked for
+                if (w > 0) break;
+                world.rockCount = rockCount;
+            }
+            if (missileCount > 0) world.missileCount = missileCount;
+
+            for (unsigned int c = 0; c < caseCount; c++)
+            {
+                if (filter && !strstr(benchCases[c].name, filter)) continue;
+                if (resultCount == BENCH_MAX_RESULTS) break;
+
+                BenchResult result = RunBenchCase(&benchCases[c], &world);
+                results[resultCount++] = result;
+                printf("%-32s %-8s %7u %9u %14.1f %12.2f %12.2f %12u\n",
+                       result.name, (layout == LAYOUT_EDGE)? "edge" : "interior",
+                       world.rockCount, world.missileCount,
+                       result.nsPerTick, result.nsPerEntity, result.allocsPerTick, result.bytes);
+            }
+        }
+    }
+
+    if (jsonPath) WriteResultsJson(jsonPath, label);
+
+    FreeSnapshot(&benchSnapshot);
+    FreeGameState();
+    FreeJobSystem();
+
+    return 0;
+}
+
+void BuildWorld(const BenchWorld *world)
+{
+    SeedRandomStream(&benchRandom, BENCH_SEED, RANDOM_WORLD);
+
+    // Every build plays out the same, splits included
+    for (unsigned int i = 0; i < RANDOM_STREAM_COUNT; i++)
+        SeedRandomStream(&game.random[i], BENCH_SEED, (RandomStreamId)i);
+    game.eliminatedCount = 0;
+
+    // Room for every rock in the world to split once
+    unsigned int capacity = world->rockCount*2 + ASTEROID_POOL_SIZE;
+    FreeAsteroidPool(&game.rocks);
+    FreeMissilePool(&game.missiles);
+    FreeCollisionGrid(&game.rockGrid);
+    InitAsteroidPool(&game.rocks, capacity);
+    InitMissilePool(&game.missiles, (world->missileCount > 0)? world->missileCount : 1);
+    InitCollisionGrid(&game.rockGrid, capacity, ASTEROID_GRID_CELL_SIZE);
+
+    for (unsigned int i = 0; i < world->rockCount; i++)
+    {
+        SizeOfAsteroid size = (SizeOfAsteroid)GetRandomInt(&benchRandom, ASTEROID_SIZE_SMALL, ASTEROID_SIZE_BIG);
+        float angle;
+        Vector2 position = GetLayoutPosition(world->layout, GetAsteroidRadius(size), &angle);
+        CreateAsteroid(size, position, angle, BROWN);
+    }
+
+    // Fire every missile, then move it to its place in the layout
+    MissilePool *shots = &game.missiles;
+    for (unsigned int i = 0; i < world->missileCount; i++)
+    {
+        float angle;
+        Vector2 position = GetLayoutPosition(world->layout, MISSILE_RADIUS, &angle);
+        unsigned int shot = shots->nextShot;
+        game.ship.rotation = angle + 180.0f; // shots head off at rotation + 180
+        ShootMissile(&game.ship);
+        shots->position[shot] = position;
+        shots->previousPosition[shot] = position;
+    }
+
+    // Ship flying through the middle, turning and thrusting every tick
+    game.ship = (SpaceShip){
+        .position = { VIRTUAL_WIDTH/2, VIRTUAL_HEIGHT/2 },
+        .previousPosition = { VIRTUAL_WIDTH/2, VIRTUAL_HEIGHT/2 },
+        .width = SHIP_WIDTH,
+        .length = SHIP_LENGTH,
+        .respawnTimer = SHIP_RESPAWN_TIME,
+    };
+    UpdateShipPoints(&game.ship);
+    savedShip = game.ship;
+    game.input = (TickInput){
+        .actionsDown = INPUT_ACTION_BIT(INPUT_ACTION_FORWARD) | INPUT_ACTION_BIT(INPUT_ACTION_RIGHT),
+    };
+
+    BuildCollisionGrid(&game.rockGrid, game.rocks.position, game.rocks.count);
+    SaveSnapshot(&benchSnapshot); // sized here, so the timed saves don't allocate
+}
+
+Vector2 GetLayoutPosition(BenchLayout layout, float margin, float *angle)
+{
+    float x = (float)GetRandomInt(&benchRandom, 0, VIRTUAL_WIDTH);
+    float y = (float)GetRandomInt(&benchRandom, 0, VIRTUAL_HEIGHT);
+
+    if (layout == LAYOUT_EDGE)
+    {
+        // Straddle one of the edges, heading along it so the object stays there
+        int side = GetRandomInt(&benchRandom, 0, 3);
+        float overlap = (float)GetRandomInt(&benchRandom, 0, (int)margin) - margin/2;
+        if (side < 2)
+        {
+            x = (side == 0)? overlap : VIRTUAL_WIDTH + overlap;
+            *angle = (float)(GetRandomInt(&benchRandom, 0, 1)*180); // vertical
+        }
+        else
+        {
+            y = (side == 2)? overlap : VIRTUAL_HEIGHT + overlap;
+            *angle = (float)(GetRandomInt(&benchRandom, 0, 1)*180 + 90); // horizontal
+        }
+        Vector2 position = { x, y };
+        WrapPastEdge(&position);
+        return position;
+    }
+
+    // Far enough from the edges to not reach them within a batch
+    float drift = (MISSILE_SPEED + ASTEROID_SPEED)*SIM_TICK_TIME*BENCH_TICKS_PER_BATCH;
+    float inset = margin + drift;
+    x = inset + (float)GetRandomInt(&benchRandom, 0, (int)(VIRTUAL_WIDTH - 2*inset));
+    y = inset + (float)GetRandomInt(&benchRandom, 0, (int)(VIRTUAL_HEIGHT - 2*inset));
+    *angle = (float)GetRandomInt(&benchRandom, 0, 360);
+
+    return (Vector2){ x, y };
+}
+
+BenchResult RunBenchCase(const BenchCase *bench, const BenchWorld *world)
+{
+    unsigned int ticksPerBatch = bench->rebuildEachTick? 1 : BENCH_TICKS_PER_BATCH;
+    unsigned long long ticks = 0;
+    unsigned long long allocations = 0;
+    double elapsed = 0.0;
+
+    // World rebuilds are left out of the timing
+    double caseStart = GetTime();
+    for (unsigned int batch = 0; batch < BENCH_MIN_BATCHES || elapsed < BENCH_MIN_TIME; batch++)
+    {
+        if (batch >= BENCH_MIN_BATCHES && GetTime() - caseStart > BENCH_MAX_TIME) break;
+
+        BuildWorld(world);
+
+        unsigned long long allocationsStart = allocator.count;
+        double start = GetTime();
+        for (unsigned int t = 0; t < ticksPerBatch; t++)
+            bench->RunTick();
+        elapsed += GetTime() - start;
+        allocations += allocator.count - allocationsStart;
+        ticks += ticksPerBatch;
+    }
+
+    BenchResult result = {
+        .name = bench->name,
+        .world = *world,
+        .threadCount = jobs.threadCount,
+        .ticks = ticks,
+        .nsPerTick = elapsed*1e9/ticks,
+        .allocsPerTick = (double)allocations/ticks,
+    };
+    if (bench->reportsBytes) result.bytes = benchSnapshot.size;
+    unsigned int entityCount = bench->GetEntityCount(world);
+    result.nsPerEntity = (entityCount > 0)? result.nsPerTick/entityCount : 0.0;
+
+    return result;
+}
+
+BenchResult RunReplay(void)
+{
+    InitGameState(replay.seed);
+    game.currentScreen = SCREEN_GAMEPLAY;
+
+    double *tickTimes = malloc((replay.tickCount + 1)*sizeof(double));
+    unsigned int slowestTick = 0;
+    double elapsed = 0.0;
+    unsigned long long allocationsStart = allocator.count;
+    for (unsigned int t = 0; t < replay.tickCount; t++)
+    {
+        PlayReplayTick(&game.input);
+        double start = GetTime();
+        UpdateGameTick();
+        tickTimes[t] = GetTime() - start;
+        ConsumeTickInput(&game.input);
+
+        elapsed += tickTimes[t];
+        if (tickTimes[t] > tickTimes[slowestTick]) slowestTick = t;
+    }
+    unsigned int ticks = (replay.tickCount > 0)? replay.tickCount : 1;
+
+    BenchResult result = {
+        .name = "Replay",
+        .world = { .rockCount = game.rocks.peakCount, .missileCount = game.missiles.capacity },
+        .threadCount = jobs.threadCount,
+        .ticks = replay.tickCount,
+        .nsPerTick = elapsed*1e9/ticks,
+        .allocsPerTick = (double)(allocator.count - allocationsStart)/ticks,
+    };
+    result.nsPerEntity = result.nsPerTick/(result.world.rockCount + result.world.missileCount + 1);
+
+    printf("replay:      %u ticks (%.1f s of game time), seed %u\n",
+           replay.tickCount, replay.tickCount*(double)SIM_TICK_TIME, replay.seed);
+    if (replay.tickCount > 0)
+    {
+        double slowest = tickTimes[slowestTick];
+        qsort(tickTimes, replay.tickCount, sizeof(double), CompareDoubles);
+        printf("ns/tick:     mean %.1f, p50 %.1f, p99 %.1f, max %.1f (tick %u)\n",
+               result.nsPerTick, tickTimes[replay.tickCount/2]*1e9,
+               tickTimes[(unsigned int)(replay.tickCount*0.99)]*1e9, slowest*1e9, slowestTick);
+    }
+    printf("allocs/tick: %.2f\n", result.allocsPerTick);
+
+    free(tickTimes);
+    FreeGameState();
+
+    return result;
+}
+
+void RunScaling(const BenchWorld *world, unsigned int maxThreads)
+{
+    static const BenchCase tickCase = { "UpdateGameTick", RunUpdateGameTick, GetEntityCount, false, false };
+    if (maxThreads > JOBS_MAX_THREADS) maxThreads = JOBS_MAX_THREADS;
+
+    printf("UpdateGameTick, %u rocks, %u missiles, %u cores\n", world->rockCount, world->missileCount, GetCpuCount());
+    printf("%8s %14s %9s %12s %14s\n", "threads", "ns/tick", "speedup", "steals/job", "deterministic");
+
+    double singleThreaded = 0.0;
+    for (unsigned int threads = 1; threads <= maxThreads && resultCount < BENCH_MAX_RESULTS; )
+    {
+        InitJobSystem(threads);
+
+        bool isDeterministic = CheckScalingSnapshot(world, threads == 1);
+        unsigned long long jobsBefore = jobs.jobCount;
+        unsigned long long stealsBefore = jobs.stealCount;
+        BenchResult result = RunBenchCase(&tickCase, world);
+        unsigned long long jobCount = jobs.jobCount - jobsBefore;
+        results[resultCount++] = result;
+
+        if (threads == 1) singleThreaded = result.nsPerTick;
+        printf("%8u %14.1f %8.2fx %12.2f %14s\n", jobs.threadCount, result.nsPerTick,
+               singleThreaded/result.nsPerTick,
+               (jobCount > 0)? (double)(jobs.stealCount - stealsBefore)/jobCount : 0.0,
+               isDeterministic? "yes" : "NO");
+
+        FreeJobSystem();
+
+        // Powers of two, then the core count itself
+        if (threads == maxThreads) break;
+        threads = (threads*2 < maxThreads)? threads*2 : maxThreads;
+    }
+}
+
+bool CheckScalingSnapshot(const BenchWorld *world, bool isReference)
+{
+    BuildWorld(world);
+    for (unsigned int t = 0; t < BENCH_SCALING_CHECK_TICKS; t++)
+        UpdateGameTick();
+
+    if (isReference) return SaveSnapshot(&scalingSnapshot);
+
+    SaveSnapshot(&benchSnapshot);
+    return benchSnapshot.size == scalingSnapshot.size &&
+           memcmp(benchSnapshot.data, scalingSnapshot.data, scalingSnapshot.size) == 0;
+}
+
+int CompareDoubles(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+void WriteResultsJson(const char *path, const char *label)
+{
+    FILE *file = fopen(path, "w");
+    if (!file)
+    {
+        fprintf(stderr, "Could not write %s\n", path);
+        return;
+    }
+
+    fprintf(file, "{\n");
+    fprintf(file, "  \"label\": \"%s\",\n", label);
+    fprintf(file, "  \"tick_rate\": %d,\n", SIM_TICK_RATE);
+    fprintf(file, "  \"results\": [\n");
+    for (unsigned int i = 0; i < resultCount; i++)
+    {
+        BenchResult *result = &results[i];
+        fprintf(file, "    { \"name\": \"%s\", \"layout\": \"%s\", \"rocks\": %u, \"missiles\": %u, \"threads\": %u, "
+                      "\"ticks\": %llu, \"ns_per_tick\": %.1f, \"ns_per_entity\": %.3f, \"allocs_per_tick\": %.3f, \"bytes\": %u }%s\n",
+                result->name, (result->world.layout == LAYOUT_EDGE)? "edge" : "interior",
+                result->world.rockCount, result->world.missileCount, result->threadCount, result->ticks,
+                result->nsPerTick, result->nsPerEntity, result->allocsPerTick, result->bytes,
+                (i + 1 < resultCount)? "," : "");
+    }
+    fprintf(file, "  ]\n");
+    fprintf(file, "}\n");
+
+    fclose(file);
+    printf("Results written to %s\n", path);
+}
+
+void RunUpdateAsteroids(void)
+{
+    UpdateAsteroids();
+}
+
+void RunUpdateMissiles(void)
+{
+    UpdateMissiles();
+}
+
+void RunUpdateShip(void)
+{
+    // Keep the ship on its hot path, it would stop updating once it crashes
+    game.ship.exploded = false;
+    UpdateShip(&game.ship);
+}
+
+void RunCheckCollisionAsteroidShip(void)
+{
+    unsigned int hits = 0;
+    for (unsigned int i = 0; i < game.rocks.count; i++)
+        hits += CheckCollisionAsteroidShip(i, &savedShip);
+    benchSink = hits;
+}
+
+void RunCheckCollisionMissilesAsteroids(void)
+{
+    CheckCollisionMissilesAsteroids();
+}
+
+void RunCircleTestScalar(void)
+{
+    AsteroidPool *rocks = &game.rocks;
+    MissilePool *shots = &game.missiles;
+    unsigned int missileCount = (shots->liveCount < BENCH_PAIR_MISSILES)? shots->liveCount : BENCH_PAIR_MISSILES;
+
+    unsigned int hits = 0;
+    for (unsigned int s = 0; s < missileCount; s++)
+    {
+        unsigned int shot = shots->liveIds[s];
+        for (unsigned int i = 0; i < rocks->count; i++)
+            hits += CheckCollisionCirclesToroidal(rocks->position[i], rocks->radius[i], shots->position[shot], shots->radius[shot]);
+    }
+    benchSink = hits;
+}
+
+void RunCheckCirclesToroidal(void)
+{
+    AsteroidPool *rocks = &game.rocks;
+    MissilePool *shots = &game.missiles;
+    unsigned int missileCount = (shots->liveCount < BENCH_PAIR_MISSILES)? shots->liveCount : BENCH_PAIR_MISSILES;
+
+    unsigned int hits = 0;
+    for (unsigned int s = 0; s < missileCount; s++)
+    {
+        unsigned int shot = shots->liveIds[s];
+        for (unsigned int i = 0; i < rocks->count; i += KERNEL_MAX_BATCH)
+        {
+            unsigned int batch = (rocks->count - i < KERNEL_MAX_BATCH)? rocks->count - i : KERNEL_MAX_BATCH;
+            hits += CountHits(CheckCirclesToroidal(shots->position[shot], shots->radius[shot],
+                                                   &rocks->position[i], &rocks->radius[i], 0, batch));
+        }
+    }
+    benchSink = hits;
+}
+
+void RunCheckCirclesToroidalIndexed(void)
+{
+    // Every rock in grid order, the way the broadphase hands them over
+    AsteroidPool *rocks = &game.rocks;
+    MissilePool *shots = &game.missiles;
+    const unsigned int *items = game.rockGrid.cellItems;
+    unsigned int missileCount = (shots->liveCount < BENCH_PAIR_MISSILES)? shots->liveCount : BENCH_PAIR_MISSILES;
+
+    unsigned int hits = 0;
+    for (unsigned int s = 0; s < missileCount; s++)
+    {
+        unsigned int shot = shots->liveIds[s];
+        for (unsigned int i = 0; i < rocks->count; i += KERNEL_MAX_BATCH)
+        {
+            unsigned int batch = (rocks->count - i < KERNEL_MAX_BATCH)? rocks->count - i : KERNEL_MAX_BATCH;
+            hits += CountHits(CheckCirclesToroidal(shots->position[shot], shots->radius[shot],
+                                                   rocks->position, rocks->radius, &items[i], batch));
+        }
+    }
+    benchSink = hits;
+}
+
+void RunUpdateGameTick(void)
+{
+    UpdateGameTick();
+}
+
+void RunSaveSnapshot(void)
+{
+    SaveSnapshot(&benchSnapshot);
+}
+
+void RunRestoreSnapshot(void)
+{
+    RestoreSnapshot(&benchSnapshot);
+}
+
+unsigned int GetRockCount(const BenchWorld *world) { return world->rockCount; }
+unsigned int GetMissileCount(const BenchWorld *world) { return world->missileCount; }
+unsigned int GetShipCount(const BenchWorld *world) { (void)world; return 1; }
+unsigned int GetEntityCount(const BenchWorld *world) { return world->rockCount + world->missileCount + 1; }
+unsigned int GetPairCount(const BenchWorld *world)
+{
+    return world->rockCount*((world->missileCount < BENCH_PAIR_MISSILES)? world->missileCount : BENCH_PAIR_MISSILES);
+}
+
+unsigned int CountHits(unsigned int hits)
+{
+    unsigned int count = 0;
+    for (; hits; hits &= hits - 1) count++;
+    return count;
+}
@@ -105,17 +105,17 @@ if "%cmake%"=="1"   (
 
 :: Compile/Link Line Definitions
 :: ----------------------------------------------------------------------------
-set cc_common=   -I"raylib\include" -Wall -std=c99 -D_DEFAULT_SOURCE -Wno-missing-braces -Wunused-result -Wextra -Wmissing-prototypes -Wstrict-prototypes
+set cc_common=   -I"raylib\include" -Wall -std=c99 -D_DEFAULT_SOURCE -Wno-missing-braces -Wunused-result -Wextra -Wmissing-prototypes -Wstrict-prototypes -ffp-contract=off
 set cc_link=     -L"raylib\lib\windows" -lraylib -lopengl32 -lgdi32 -lwinmm
 set cc_debug=    -g -O0
-set cc_release=  -O2
+set cc_release=  -O2 -DNDEBUG
 set web_release= -O3
 set web_link=    -L"raylib\lib\web" -lraylib --shell-file "%web_shell%" -sUSE_GLFW=3 -sTOTAL_MEMORY=67108864 -sFORCE_FILESYSTEM=1 -sASYNCIFY -sEXPORTED_FUNCTIONS=_main,requestFullscreen -sEXPORTED_RUNTIME_METHODS=HEAPF32
 set cc_out=      -o
-set cl_common=   cl /I"raylib\include" /W3 /MD /Zi /DPLATFORM_DESKTOP
+set cl_common=   cl /I"raylib\include" /W3 /MD /Zi /fp:precise /DPLATFORM_DESKTOP
 set cl_link=     /link /INCREMENTAL:NO /LIBPATH:"raylib\lib\windows-msvc" raylib.lib gdi32.lib winmm.lib user32.lib shell32.lib
 set cl_debug=    -Od /DEBUG
-set cl_release=  -O3
+set cl_release=  -O3 -DNDEBUG
 set cl_out=      /Fe:
 set platform_desktop=-DPLATFORM_DESKTOP
 set platform_web=-DPLATFORM_WEB
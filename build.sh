@@ -108,10 +108,10 @@ script_choose_cmake_lines()
 script_choose_simple_lines()
 {
     # Line Definitions
-    cc_common='-I"raylib/include" -Wall -std=c99 -D_DEFAULT_SOURCE -Wno-missing-braces -Wunused-result -Wextra -Wmissing-prototypes -Wstrict-prototypes'
+    cc_common='-I"raylib/include" -Wall -std=c99 -D_DEFAULT_SOURCE -Wno-missing-braces -Wunused-result -Wextra -Wmissing-prototypes -Wstrict-prototypes -ffp-contract=off'
     cc_link='-lraylib -lGL -lm -lpthread -ldl -lrt -lX11'
     cc_debug='-g -O0'
-    cc_release='-O2'
+    cc_release='-O2 -DNDEBUG'
     cc_out='-o'
     web_release='-O3'
     web_link='-L"raylib/lib/web" -lraylib --shell-file "$web_shell" -sUSE_GLFW=3 -sTOTAL_MEMORY=67108864 -sFORCE_FILESYSTEM=1 -sASYNCIFY -sEXPORTED_FUNCTIONS=_main,requestFullscreen -sEXPORTED_RUNTIME_METHODS=HEAPF32'
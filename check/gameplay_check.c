@@ -0,0 +1,116 @@
+// EXPLANATION:
+// Gameplay rules checked on the headless platform
+// Each case sets up a tiny world by hand, steps the real game tick and checks
+// the outcome, so rules that only show up as a rare frame in play (like the
+// order collisions are resolved in) can't quietly change.
+//
+// Usage: asteroids_gameplay_check [--filter NAME]
+
+#include "../code/asteroids.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../code/config.h"
+
+#define CHECK_SEED 1
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+
+typedef struct GameplayCase {
+    const char *name;
+    bool (*Run)(void); // true if the game did what it should
+} GameplayCase;
+
+// Globals
+// ----------------------------------------------------------------------------
+GameState game; // game data
+
+// Local Functions Declaration
+// ----------------------------------------------------------------------------
+void StartEmptyWorld(void); // Seeded game with no rocks, the ship in the middle
+unsigned int PlaceRockOnShip(void); // Big still rock over the ship, returns its index
+
+bool RunShotRockSparesShip(void);
+bool RunUnshotRockKillsShip(void);
+
+static const GameplayCase gameplayCases[] = {
+    { "ShotRockSparesShip", RunShotRockSparesShip },
+    { "UnshotRockKillsShip", RunUnshotRockKillsShip }, // the world above really does touch the ship
+};
+
+int main(int argc, char **argv)
+{
+    const char *filter = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else
+        {
+            fprintf(stderr, "Usage: %s [--filter NAME]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    SetTraceLogLevel(LOG_ERROR);
+    unsigned int failCount = 0;
+    unsigned int caseCount = sizeof(gameplayCases)/sizeof(gameplayCases[0]);
+    for (unsigned int c = 0; c < caseCount; c++)
+    {
+        if (filter && !strstr(gameplayCases[c].name, filter)) continue;
+
+        bool passed = gameplayCases[c].Run();
+        FreeGameState();
+        printf("%-24s %s\n", gameplayCases[c].name, passed? "ok" : "FAIL");
+        if (!passed) failCount++;
+    }
+
+    if (failCount > 0)
+    {
+        fprintf(stderr, "FAIL: %u gameplay cases\n", failCount);
+        return 1;
+    }
+
+    return 0;
+}
+
+void StartEmptyWorld(void)
+{
+    InitGameState(CHECK_SEED);
+    game.currentScreen = SCREEN_GAMEPLAY;
+    while (game.rocks.count > 0)
+        RemoveAsteroid(0);
+}
+
+unsigned int PlaceRockOnShip(void)
+{
+    // CreateAsteroid leaves the spot alone, only CreateAsteroidRandom keeps clear of the ship
+    unsigned int rock = GetAsteroidIndex(CreateAsteroid(ASTEROID_SIZE_BIG, game.ship.position, 0.0f, BROWN));
+    game.rocks.velocity[rock] = (Vector2){ 0.0f, 0.0f };
+    return rock;
+}
+
+bool RunShotRockSparesShip(void)
+{
+    StartEmptyWorld();
+    PlaceRockOnShip();
+
+    // The missile starts inside the rock, so it hits in the same tick the
+    // ship would. The shot rock is gone, it mustn't take the ship with it
+    ShootMissile(&game.ship);
+    UpdateGameTick();
+
+    return (game.eliminatedCount == 1) && !game.ship.exploded;
+}
+
+bool RunUnshotRockKillsShip(void)
+{
+    StartEmptyWorld();
+    PlaceRockOnShip();
+    UpdateGameTick();
+
+    return game.ship.exploded;
+}
@@ -0,0 +1,359 @@
+// EXPLANATION:
+// Checks the toroidal collision tests against the 9-clone tests they replaced
+// Plays scripted sessions (or a recorded replay) on the headless platform and
+// after every tick runs both versions on every rock/missile and rock/ship pair
+// of that tick. Those rarely touch since the game has already resolved the
+// hits, so every rock is also tested against every other rock, and against
+// the ship moved onto every other rock, for plenty of hits and near misses.
+// The old tests are kept here as they were before the switch: only rocks past
+// a screen edge tested their 8 wrapped clones.
+// Differences the switch was meant to make are counted by kind, see
+// check/README.md. Any other difference is printed and fails the run.
+//
+// Usage: asteroids_toroidal_check [--ticks N] [--seeds N] [--replay FILE]
+// --seeds plays sessions with seeds 1 to N, N ticks each (--replay plays only the recording)
+
+#include "../code/asteroids.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "raymath.h"
+
+#include "../code/collision.h"
+#include "../code/config.h"
+#include "../code/input.h"
+#include "../code/replay.h"
+
+#define CHECK_TICKS 20000
+#define CHECK_SEEDS 8
+#define CHECK_MAX_PRINTED 20 // unexplained differences printed, the rest are only counted
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+
+// How the old and new result of one pair compare, see check/README.md
+typedef enum CheckOutcome {
+    OUTCOME_SAME,
+    OUTCOME_OPPOSITE_EDGE, // new hit on the far side of an edge the old rock wasn't past
+    OUTCOME_UNEXPLAINED,
+    OUTCOME_COUNT
+} CheckOutcome;
+
+typedef struct CheckCounts {
+    unsigned long long pairs;
+    unsigned long long hits; // with the toroidal test
+    unsigned long long outcomes[OUTCOME_COUNT];
+} CheckCounts;
+
+// Globals
+// ----------------------------------------------------------------------------
+GameState game; // game data
+
+CheckCounts missileCounts;
+CheckCounts shipCounts;
+CheckCounts rockCounts;     // rock against another rock
+CheckCounts movedShipCounts; // rock against the ship moved onto another rock
+unsigned int printedCount = 0;
+
+static const Vector2 oldWrapOffsets[8] = {
+    { VIRTUAL_WIDTH, 0 },   // right
+    { -VIRTUAL_WIDTH, 0 },  // left
+    { 0, -VIRTUAL_HEIGHT }, // up
+    { 0, VIRTUAL_HEIGHT },  // down
+    { VIRTUAL_WIDTH, -VIRTUAL_HEIGHT },  // top-right
+    { -VIRTUAL_WIDTH, -VIRTUAL_HEIGHT }, // top-left
+    { VIRTUAL_WIDTH, VIRTUAL_HEIGHT },   // bottom-right
+    { -VIRTUAL_WIDTH, VIRTUAL_HEIGHT }   // bottom-left
+};
+
+static const char *outcomeNames[OUTCOME_COUNT] = {
+    "same",
+    "opposite edge",
+    "unexplained",
+};
+
+// Local Functions Declaration
+// ----------------------------------------------------------------------------
+void PlaySession(unsigned int seed, unsigned int tickCount); // Scripted, or the loaded replay
+void UpdateScriptedInput(TickInput *input, unsigned int tick); // Same pilot as the headless build
+void CheckTick(unsigned int seed, unsigned int tick); // Every pair of the game as it is now
+void CheckCirclePair(CheckCounts *counts, const char *kind, unsigned int seed, unsigned int tick,
+                     Vector2 rock, float radius, Vector2 center, float centerRadius);
+void CheckShipPair(CheckCounts *counts, const char *kind, unsigned int seed, unsigned int tick,
+                   Vector2 rock, float radius, const Vector2 shipPoints[3]);
+CheckOutcome ClassifyPair(bool oldHit, bool newHit, bool isRockOnEdge, bool isDirectHit);
+void ReportDifference(const char *kind, unsigned int seed, unsigned int tick, Vector2 rock, float radius,
+                      const Vector2 *points, unsigned int pointCount, float pointRadius, bool oldHit);
+void PrintCounts(const char *kind, const CheckCounts *counts);
+
+// The tests as they were before the toroidal ones, raylib 5.5's math
+bool OldIsCircleOnEdge(Vector2 position, float radius);
+bool OldCheckCollisionCircles(Vector2 center1, float radius1, Vector2 center2, float radius2);
+bool OldCheckCollisionPointCircle(Vector2 point, Vector2 center, float radius);
+bool OldCheckCollisionAsteroidMissile(Vector2 rock, float rockRadius, Vector2 shot, float shotRadius);
+bool OldCheckCollisionAsteroidShip(Vector2 rock, float rockRadius, const Vector2 shipPoints[3]);
+bool CheckCollisionTriangleCircle(const Vector2 points[3], Vector2 center, float radius); // No clones
+
+int main(int argc, char **argv)
+{
+    unsigned int tickCount = CHECK_TICKS;
+    unsigned int seedCount = CHECK_SEEDS;
+    const char *replayPath = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)
+            tickCount = (unsigned int)strtoul(argv[++i], 0, 10);
+        else if (strcmp(argv[i], "--seeds") == 0 && i + 1 < argc)
+            seedCount = (unsigned int)strtoul(argv[++i], 0, 10);
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            replayPath = argv[++i];
+        else
+        {
+            fprintf(stderr, "Usage: %s [--ticks N] [--seeds N] [--replay FILE]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    SetTraceLogLevel(LOG_ERROR);
+    if (replayPath)
+    {
+        if (!LoadReplay(replayPath)) return 1;
+        PlaySession(replay.seed, replay.tickCount);
+        FreeReplay();
+    }
+    else
+    {
+        for (unsigned int seed = 1; seed <= seedCount; seed++)
+            PlaySession(seed, tickCount);
+    }
+
+    PrintCounts("rock/missile", &missileCounts);
+    PrintCounts("rock/ship", &shipCounts);
+    PrintCounts("rock/rock", &rockCounts);
+    PrintCounts("rock/moved ship", &movedShipCounts);
+
+    unsigned long long unexplained = missileCounts.outcomes[OUTCOME_UNEXPLAINED] + shipCounts.outcomes[OUTCOME_UNEXPLAINED] +
+                                     rockCounts.outcomes[OUTCOME_UNEXPLAINED] + movedShipCounts.outcomes[OUTCOME_UNEXPLAINED];
+    if (unexplained > 0)
+    {
+        fprintf(stderr, "FAIL: %llu unexplained differences from the clone tests\n", unexplained);
+        return 1;
+    }
+    printf("OK: the toroidal tests only differ where check/README.md says they should\n");
+
+    return 0;
+}
+
+void PlaySession(unsigned int seed, unsigned int tickCount)
+{
+    InitGameState(seed);
+    game.currentScreen = SCREEN_GAMEPLAY;
+
+    for (unsigned int tick = 0; tick < tickCount; tick++)
+    {
+        if (replay.mode == REPLAY_PLAYING)
+            PlayReplayTick(&game.input);
+        else
+            UpdateScriptedInput(&game.input, tick);
+        UpdateGameTick();
+        ConsumeTickInput(&game.input);
+
+        CheckTick(seed, tick);
+    }
+
+    FreeGameState();
+}
+
+void UpdateScriptedInput(TickInput *input, unsigned int tick)
+{
+    unsigned int second = tick/SIM_TICK_RATE;
+
+    input->actionsDown = INPUT_ACTION_BIT(INPUT_ACTION_RIGHT);
+    if (second%2 == 0)
+        input->actionsDown |= INPUT_ACTION_BIT(INPUT_ACTION_FORWARD);
+    if (tick%((SIM_TICK_RATE >= 8)? SIM_TICK_RATE/8 : 1) == 0) // 8 shots a second, or every tick below that rate
+        input->actionsPressed |= INPUT_ACTION_BIT(INPUT_ACTION_SHOOT);
+}
+
+void CheckTick(unsigned int seed, unsigned int tick)
+{
+    const AsteroidPool *rocks = &game.rocks;
+    const MissilePool *shots = &game.missiles;
+    const SpaceShip *ship = &game.ship;
+
+    // Ship points the way CheckCollisionAsteroidShip makes them
+    Vector2 shipPoints[3];
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        shipPoints[i] = Vector2Rotate(game.shipTriangle[i], ship->rotation*DEG2RAD);
+        shipPoints[i] = Vector2Add(shipPoints[i], ship->position);
+    }
+
+    for (unsigned int rock = 0; rock < rocks->count; rock++)
+    {
+        Vector2 position = rocks->position[rock];
+        float radius = rocks->radius[rock];
+
+        for (unsigned int l = 0; l < shots->liveCount; l++)
+        {
+            unsigned int shot = shots->liveIds[l];
+            CheckCirclePair(&missileCounts, "rock/missile", seed, tick, position, radius,
+                            shots->position[shot], shots->radius[shot]);
+        }
+
+        if (!ship->exploded)
+            CheckShipPair(&shipCounts, "rock/ship", seed, tick, position, radius, shipPoints);
+
+        for (unsigned int other = 0; other < rocks->count; other++)
+        {
+            if (other == rock) continue;
+
+            Vector2 otherPosition = rocks->position[other];
+            CheckCirclePair(&rockCounts, "rock/rock", seed, tick, position, radius, otherPosition, rocks->radius[other]);
+
+            Vector2 movedShip[3];
+            for (unsigned int i = 0; i < 3; i++)
+                movedShip[i] = Vector2Add(Vector2Subtract(shipPoints[i], ship->position), otherPosition);
+            CheckShipPair(&movedShipCounts, "rock/moved ship", seed, tick, position, radius, movedShip);
+        }
+    }
+}
+
+void CheckCirclePair(CheckCounts *counts, const char *kind, unsigned int seed, unsigned int tick,
+                     Vector2 rock, float radius, Vector2 center, float centerRadius)
+{
+    bool oldHit = OldCheckCollisionAsteroidMissile(rock, radius, center, centerRadius);
+    bool newHit = CheckCollisionCirclesToroidal(rock, radius, center, centerRadius);
+    bool isDirectHit = OldCheckCollisionCircles(rock, radius, center, centerRadius);
+    CheckOutcome outcome = ClassifyPair(oldHit, newHit, OldIsCircleOnEdge(rock, radius), isDirectHit);
+
+    counts->pairs++;
+    counts->hits += newHit;
+    counts->outcomes[outcome]++;
+    if (outcome == OUTCOME_UNEXPLAINED)
+        ReportDifference(kind, seed, tick, rock, radius, &center, 1, centerRadius, oldHit);
+}
+
+void CheckShipPair(CheckCounts *counts, const char *kind, unsigned int seed, unsigned int tick,
+                   Vector2 rock, float radius, const Vector2 shipPoints[3])
+{
+    bool oldHit = OldCheckCollisionAsteroidShip(rock, radius, shipPoints);
+    bool newHit = CheckCollisionTriangleCircleToroidal(shipPoints, rock, radius);
+    bool isDirectHit = CheckCollisionTriangleCircle(shipPoints, rock, radius);
+    CheckOutcome outcome = ClassifyPair(oldHit, newHit, OldIsCircleOnEdge(rock, radius), isDirectHit);
+
+    counts->pairs++;
+    counts->hits += newHit;
+    counts->outcomes[outcome]++;
+    if (outcome == OUTCOME_UNEXPLAINED)
+        ReportDifference(kind, seed, tick, rock, radius, shipPoints, 3, 0.0f, oldHit);
+}
+
+CheckOutcome ClassifyPair(bool oldHit, bool newHit, bool isRockOnEdge, bool isDirectHit)
+{
+    if (oldHit == newHit) return OUTCOME_SAME;
+
+    // The old test never looked at the clones of a rock inside the screen, so it
+    // missed the other object reaching over from the far edge. Only a new hit
+    // through a clone is expected, anything the old test found must still hit
+    if (newHit && !isRockOnEdge && !isDirectHit) return OUTCOME_OPPOSITE_EDGE;
+
+    return OUTCOME_UNEXPLAINED;
+}
+
+void ReportDifference(const char *kind, unsigned int seed, unsigned int tick, Vector2 rock, float radius,
+                      const Vector2 *points, unsigned int pointCount, float pointRadius, bool oldHit)
+{
+    if (printedCount++ >= CHECK_MAX_PRINTED) return;
+
+    fprintf(stderr, "%s, seed %u tick %u: clone test %s, toroidal test %s\n", kind, seed, tick,
+            oldHit? "hit" : "missed", oldHit? "missed" : "hit");
+    fprintf(stderr, "    rock (%.9g, %.9g) radius %.9g\n", rock.x, rock.y, radius);
+    for (unsigned int i = 0; i < pointCount; i++)
+        fprintf(stderr, "    against (%.9g, %.9g) radius %.9g\n", points[i].x, points[i].y, pointRadius);
+}
+
+void PrintCounts(const char *kind, const CheckCounts *counts)
+{
+    printf("%-16s %llu pairs, %llu hits", kind, counts->pairs, counts->hits);
+    for (unsigned int o = 0; o < OUTCOME_COUNT; o++)
+        printf(", %s %llu", outcomeNames[o], counts->outcomes[o]);
+    printf("\n");
+}
+
+bool OldIsCircleOnEdge(Vector2 position, float radius)
+{
+    if ((position.x - radius < 0) ||
+        (position.x + radius > VIRTUAL_WIDTH) ||
+        (position.y - radius < 0) ||
+        (position.y + radius > VIRTUAL_HEIGHT))
+        return true; // Circular object is past the edge
+
+    // Circular object is not past edge
+    return false;
+}
+
+bool OldCheckCollisionCircles(Vector2 center1, float radius1, Vector2 center2, float radius2)
+{
+    float dx = center2.x - center1.x;
+    float dy = center2.y - center1.y;
+    float distanceSquared = dx*dx + dy*dy;
+
+    return (distanceSquared <= (radius1 + radius2)*(radius1 + radius2));
+}
+
+bool OldCheckCollisionPointCircle(Vector2 point, Vector2 center, float radius)
+{
+    float distanceSquared = (point.x - center.x)*(point.x - center.x) + (point.y - center.y)*(point.y - center.y);
+
+    return (distanceSquared <= radius*radius);
+}
+
+bool OldCheckCollisionAsteroidMissile(Vector2 rock, float rockRadius, Vector2 shot, float shotRadius)
+{
+    if (OldCheckCollisionCircles(rock, rockRadius, shot, shotRadius))
+        return true;
+
+    if (OldIsCircleOnEdge(rock, rockRadius))
+    {
+        for (unsigned int o = 0; o < 8; o++)
+        {
+            Vector2 cloneRock = Vector2Add(rock, oldWrapOffsets[o]);
+            if (OldCheckCollisionCircles(cloneRock, rockRadius, shot, shotRadius))
+                return true;
+        }
+    }
+
+    return false;
+}
+
+bool OldCheckCollisionAsteroidShip(Vector2 rock, float rockRadius, const Vector2 shipPoints[3])
+{
+    if (CheckCollisionTriangleCircle(shipPoints, rock, rockRadius))
+        return true;
+
+    if (OldIsCircleOnEdge(rock, rockRadius))
+    {
+        for (unsigned int o = 0; o < 8; o++)
+        {
+            if (CheckCollisionTriangleCircle(shipPoints, Vector2Add(rock, oldWrapOffsets[o]), rockRadius))
+                return true;
+        }
+    }
+
+    return false;
+}
+
+bool CheckCollisionTriangleCircle(const Vector2 points[3], Vector2 center, float radius)
+{
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        if (OldCheckCollisionPointCircle(points[i], center, radius))
+            return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,113 @@
+// EXPLANATION:
+// Tracking layer over raylib's MemAlloc/MemRealloc/MemFree
+// See allocator.h for more documentation/descriptions
+
+#include "allocator.h"
+
+#include <string.h> // for strcmp
+#include "raylib.h"
+
+// Every block starts with its size, padded to 16 bytes so the memory
+// after it is as aligned as what MemAlloc returns
+typedef struct AllocHeader {
+    unsigned long long size;
+    unsigned long long padding;
+} AllocHeader;
+
+// Globals
+// ----------------------------------------------------------------------------
+AllocatorState allocator = { 0 };
+
+// Local Functions Declaration
+// ----------------------------------------------------------------------------
+void RecordAllocSite(const char *file, int line, unsigned int size);
+
+void *TrackedAlloc(unsigned int size, const char *file, int line)
+{
+    AllocHeader *header = MemAlloc(sizeof(AllocHeader) + size);
+    if (!header) return 0;
+
+    header->size = size;
+    RecordAllocSite(file, line, size);
+    allocator.bytesInUse += size;
+    if (allocator.bytesInUse > allocator.peakBytes)
+        allocator.peakBytes = allocator.bytesInUse;
+
+    return header + 1;
+}
+
+void *TrackedRealloc(void *ptr, unsigned int size, const char *file, int line)
+{
+    if (!ptr) return TrackedAlloc(size, file, line);
+
+    AllocHeader *header = (AllocHeader *)ptr - 1;
+    unsigned long long oldSize = header->size;
+    header = MemRealloc(header, sizeof(AllocHeader) + size);
+    if (!header) return 0; // the old block is still valid and tracked
+
+    header->size = size;
+    RecordAllocSite(file, line, size);
+    allocator.bytesInUse += size;
+    allocator.bytesInUse -= oldSize;
+    if (allocator.bytesInUse > allocator.peakBytes)
+        allocator.peakBytes = allocator.bytesInUse;
+
+    return header + 1;
+}
+
+void TrackedFree(void *ptr)
+{
+    if (!ptr) return;
+
+    AllocHeader *header = (AllocHeader *)ptr - 1;
+    allocator.bytesInUse -= header->size;
+    MemFree(header);
+}
+
+void BeginAllocFrame(void)
+{
+    allocator.lastFrameCount = allocator.frameCount;
+    allocator.frameCount = 0;
+}
+
+void LogAllocSites(int logLevel)
+{
+    TraceLog(logLevel, "ALLOC: %llu allocations, %llu bytes in use, %llu bytes peak",
+             allocator.count, allocator.bytesInUse, allocator.peakBytes);
+    for (unsigned int i = 0; i < allocator.siteCount; i++)
+    {
+        AllocSite *site = &allocator.sites[i];
+        TraceLog(logLevel, "ALLOC:     %s:%d  %u allocations, %llu bytes",
+                 site->file, site->line, site->count, site->bytes);
+    }
+}
+
+void RecordAllocSite(const char *file, int line, unsigned int size)
+{
+    allocator.count++;
+    allocator.frameCount++;
+
+    // Few sites and allocating is rare, a linear search is plenty
+    unsigned int site = 0;
+    while (site < allocator.siteCount &&
+           (allocator.sites[site].line != line || strcmp(allocator.sites[site].file, file) != 0))
+        site++;
+
+    if (site == allocator.siteCount)
+    {
+        if (allocator.siteCount < ALLOC_MAX_SITES)
+        {
+            allocator.sites[site] = (AllocSite){ .file = file, .line = line };
+            allocator.siteCount++;
+        }
+        else
+        {
+            site = ALLOC_MAX_SITES - 1;
+            allocator.sites[site].file = "(other)";
+            allocator.sites[site].line = 0;
+        }
+    }
+
+    allocator.sites[site].count++;
+    allocator.sites[site].bytes += size;
+}
@@ -0,0 +1,50 @@
+// EXPLANATION:
+// Tracking layer over raylib's MemAlloc/MemRealloc/MemFree
+// - All of the game's heap memory goes through GameAlloc/GameRealloc/GameFree,
+//   which count allocations and bytes per call site (file:line) along with
+//   the bytes in use, the peak, and the allocations made each frame
+// - Shown in the profiler overlay, and the headless build can fail a run
+//   that allocates during gameplay ticks (--fail-on-alloc)
+
+#ifndef ASTEROIDS_ALLOCATOR_HEADER_GUARD
+#define ASTEROIDS_ALLOCATOR_HEADER_GUARD
+
+// Macros
+// ----------------------------------------------------------------------------
+#define ALLOC_MAX_SITES 64 // call sites tracked separately, the rest share the last one
+
+#define GameAlloc(size) TrackedAlloc((size), __FILE__, __LINE__)
+#define GameRealloc(ptr, size) TrackedRealloc((ptr), (size), __FILE__, __LINE__)
+#define GameFree(ptr) TrackedFree(ptr)
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+
+typedef struct AllocSite {
+    const char *file;
+    int line;
+    unsigned int count;       // allocations and reallocations made here
+    unsigned long long bytes; // total asked for here
+} AllocSite;
+
+typedef struct AllocatorState {
+    AllocSite sites[ALLOC_MAX_SITES];
+    unsigned int siteCount;
+    unsigned long long count; // allocations and reallocations so far
+    unsigned long long bytesInUse;
+    unsigned long long peakBytes;
+    unsigned int frameCount;     // allocations since BeginAllocFrame
+    unsigned int lastFrameCount; // allocations in the last full frame
+} AllocatorState;
+
+extern AllocatorState allocator; // global declaration
+
+// Prototypes
+// ----------------------------------------------------------------------------
+void *TrackedAlloc(unsigned int size, const char *file, int line); // Zeroed like MemAlloc
+void *TrackedRealloc(void *ptr, unsigned int size, const char *file, int line);
+void TrackedFree(void *ptr);
+void BeginAllocFrame(void); // Start counting a new frame's allocations
+void LogAllocSites(int logLevel); // TraceLog every call site's counts
+
+#endif // ASTEROIDS_ALLOCATOR_HEADER_GUARD
@@ -4,20 +4,37 @@
 
 #include "asteroids.h"
 
-#include <limits.h> // for SHRT_MAX for beep sound math
+#include <assert.h>
+#include <string.h> // for memcpy
 #include "raymath.h" // needed for vector math
 
+#include "allocator.h"
 #include "config.h"
 #include "input.h"
+#include "jobs.h"
+#include "kernels.h"
+#include "latency.h"
+#include "platform.h"
+#include "profiler.h"
+#include "render.h"
 #include "ui.h"
 
-#define ARRAY_SIZE(arr) (sizeof(arr)/sizeof((arr)[0]))
+// Local Functions Declaration
+// ----------------------------------------------------------------------------
 
-void InitGameState(void)
+// Job chunks of the parallel phases, see jobs.h
+// Each one only writes to its own items, so the result doesn't depend on the thread count
+void MoveAsteroidChunk(void *context, unsigned int chunk, unsigned int begin, unsigned int end);
+void CheckMissileChunk(void *context, unsigned int chunk, unsigned int begin, unsigned int end); // Finds the rock each missile hit first, doesn't touch the rocks
+void MoveMissileChunk(void *context, unsigned int chunk, unsigned int begin, unsigned int end);
+void DropExplodedMissiles(MissilePool *pool); // Take missiles flagged ENTITY_EXPLODED off liveIds, in order
+
+void InitGameState(unsigned int seed)
 {
     game = (GameState){
         // Game boots to raylib logo animation
         .currentScreen = SCREEN_LOGO,
+        .seed = seed,
 
         // Center camera
         .camera.target = (Vector2){ VIRTUAL_WIDTH/2, VIRTUAL_HEIGHT/2 },
@@ -27,9 +44,14 @@ void InitGameState(void)
                 VIRTUAL_WIDTH/2,
                 VIRTUAL_HEIGHT/2,
             },
+            .previousPosition = {
+                VIRTUAL_WIDTH/2,
+                VIRTUAL_HEIGHT/2,
+            },
             .width = SHIP_WIDTH,
             .length = SHIP_LENGTH,
             .rotation = 90.0f, // pointing right
+            .previousRotation = 90.0f,
             .respawnTimer = SHIP_RESPAWN_TIME,
         },
 
@@ -45,276 +67,440 @@ void InitGameState(void)
             (Vector2){  SHIP_WIDTH/6, -SHIP_WIDTH/2 },
         },
 
-        .wrapOffsets = {
-            { VIRTUAL_WIDTH, 0 },   // right
-            { -VIRTUAL_WIDTH, 0 },  // left
-            { 0, -VIRTUAL_HEIGHT }, // up
-            { 0, VIRTUAL_HEIGHT },  // down
-            { VIRTUAL_WIDTH, -VIRTUAL_HEIGHT },  // top-right
-            { -VIRTUAL_WIDTH, -VIRTUAL_HEIGHT }, // top-left
-            { VIRTUAL_WIDTH, VIRTUAL_HEIGHT },   // bottom-right
-            { -VIRTUAL_WIDTH, VIRTUAL_HEIGHT }   // bottom-left
-        },
-
         // .lives = 3,
     };
 
+    // Everything random in a session comes after this
+    for (unsigned int i = 0; i < RANDOM_STREAM_COUNT; i++)
+        SeedRandomStream(&game.random[i], seed, (RandomStreamId)i);
+
     // Generate random stars
     for (unsigned int i = 0; i < STAR_AMOUNT; i++)
     {
-        game.stars[i].x = (float)GetRandomValue(0, VIRTUAL_WIDTH);
-        game.stars[i].y = (float)GetRandomValue(0, VIRTUAL_HEIGHT);
+        game.stars[i].x = GetRandomFloat(&game.random[RANDOM_COSMETIC], 0, VIRTUAL_WIDTH);
+        game.stars[i].y = GetRandomFloat(&game.random[RANDOM_COSMETIC], 0, VIRTUAL_HEIGHT);
     }
 
     // Missiles / Shots
-    for (unsigned int i = 0; i < MISSILE_MAX; i++)
-    {
-        Missile *shot = &game.ship.missiles[i];
-        shot->speed = MISSILE_SPEED;
-        shot->radius = MISSILE_RADIUS;
-        shot->exploded = true; // aka non-existant
-    }
+    InitMissilePool(&game.missiles, MISSILE_MAX);
 
     // Create asteroids
+    InitAsteroidPool(&game.rocks, ASTEROID_POOL_SIZE);
+    InitCollisionGrid(&game.rockGrid, ASTEROID_POOL_SIZE, ASTEROID_GRID_CELL_SIZE);
     for (unsigned int i = 0; i < ASTEROID_COUNT; i++)
     {
         CreateAsteroidRandom(ASTEROID_SIZE_BIG);
     }
-
-    // Allocate memory for beep sine waves
-    game.beeps[BEEP_MENU] = GenBeep(300.0f, 0.03f);
-    game.beeps[BEEP_SHOOT] = GenBeep(400.0f, 0.05f);
-    game.beeps[BEEP_EXPLODE] = GenBeep(150.0f, EXPLOSION_TIME);
 }
 
-Sound GenBeep(float freq, float lengthSec)
+void FreeGameState(void)
 {
-    unsigned int sampleRate = 44100;
-    unsigned int samples = (int)(lengthSec*sampleRate);
-    short *data = MemAlloc(samples*sizeof(short));
+    FreeAsteroidPool(&game.rocks); // asteroids
+    FreeMissilePool(&game.missiles); // missiles
+    FreeCollisionGrid(&game.rockGrid);
+}
 
-    // fade length in samples
-    // (This prevents an unpleasant "pop" noise when the sound starts or stops)
-    unsigned int fadeSamples = (unsigned int)(0.005f*sampleRate); // 5 ms
+void ShootMissile(SpaceShip *ship)
+{
+    // spawn bullet, reusing the oldest slot
+    MissilePool *pool = &game.missiles;
+    unsigned int shot = pool->nextShot;
+    pool->nextShot = (pool->nextShot + 1)%pool->capacity;
 
-    // Generate wave data
-    for (unsigned int i = 0; i < samples; i++)
+    // Reused slots that were still in flight are already listed
+    if (pool->flags[shot] & ENTITY_EXPLODED)
     {
-        float timeInSeconds = (float)i/sampleRate;
-        float sample = sinf(2.0f*PI*freq*timeInSeconds);
-
-        // Apply fade in/out
-        float amplitude = 1.0f;
-        if (i < fadeSamples)
-        {
-            amplitude = (float)i/fadeSamples; // fade in
-        }
-        else if (i > samples - fadeSamples)
-        {
-            amplitude = (float)(samples - i)/fadeSamples; // fade out
-        }
-
-        data[i] = (short)(sample*amplitude*SHRT_MAX*0.25f);
+        assert(pool->liveCount < pool->capacity); // exploded missiles are off the list, see DropExplodedMissiles()
+        pool->liveIds[pool->liveCount++] = shot;
     }
 
-    Wave beepSoundWave = {
-        .frameCount = samples,
-        .sampleRate = sampleRate,
-        .sampleSize = 16,
-        .channels = 1,
-        .data = data
-    };
+    float angle = ship->rotation + 180;
+    Vector2 spawnPos = { 0, ship->length/2 + pool->radius[shot]*3 };
+    spawnPos = Vector2Rotate(spawnPos, angle*DEG2RAD);
+    spawnPos = Vector2Add(spawnPos, ship->position);
+
+    pool->position[shot] = spawnPos;
+    pool->previousPosition[shot] = spawnPos;
+    pool->velocity[shot] = Vector2Rotate((Vector2){ 0, MISSILE_SPEED }, angle*DEG2RAD);
+    pool->flags[shot] = 0;
+    pool->explosionTimer[shot] = EXPLOSION_TIME;
+    pool->despawnTimer[shot] = 0.8f;
 
-    Sound beep = LoadSoundFromWave(beepSoundWave);
-    UnloadWave(beepSoundWave); // frees data
-    return beep;
+    PlayGameBeep(BEEP_SHOOT);
 }
 
-void FreeGameState(void)
+Color ColorBrightnessVariation(Color color)
 {
-    MemFree(game.rocks); // asteroids
-    for (unsigned int i = 0; i < ARRAY_SIZE(game.beeps); i++)
-        UnloadSound(game.beeps[i]); // beeps
+    RandomStream *random = &game.random[RANDOM_COSMETIC];
+    float brightness = -0.25f*GetRandomInt(random, 0, 2); // 3 main shades
+    brightness += 0.01f*GetRandomInt(random, 1, 10); // sub-shades
+    color = ColorBrightness(color, brightness);
+    return color;
 }
 
-void ShootMissile(SpaceShip *ship)
+void InitAsteroidPool(AsteroidPool *pool, unsigned int capacity)
 {
-    // spawn bullet
-    if (ship->shotCount == MISSILE_MAX)
-        ship->shotCount = 0;
+    *pool = (AsteroidPool){ .capacity = capacity };
+    pool->position = GameAlloc(capacity*sizeof(Vector2));
+    pool->velocity = GameAlloc(capacity*sizeof(Vector2));
+    pool->radius = GameAlloc(capacity*sizeof(float));
+    pool->flags = GameAlloc(capacity*sizeof(unsigned char));
+    pool->previousPosition = GameAlloc(capacity*sizeof(Vector2));
+    pool->color = GameAlloc(capacity*sizeof(Color));
+    pool->angle = GameAlloc(capacity*sizeof(float));
+    pool->size = GameAlloc(capacity*sizeof(SizeOfAsteroid));
+    pool->slot = GameAlloc(capacity*sizeof(unsigned int));
+    pool->slotIndex = GameAlloc(capacity*sizeof(unsigned int));
+    pool->generation = GameAlloc(capacity*sizeof(unsigned int));
+    pool->freeSlots = GameAlloc(capacity*sizeof(unsigned int));
+}
 
-    Missile *shot = &ship->missiles[ship->shotCount];
+void FreeAsteroidPool(AsteroidPool *pool)
+{
+    TraceLog(LOG_DEBUG, "ASTEROIDS: Rock pool peaked at %u/%u live, %u slots reused",
+             pool->peakCount, pool->capacity, pool->reuseCount);
+    GameFree(pool->position);
+    GameFree(pool->velocity);
+    GameFree(pool->radius);
+    GameFree(pool->flags);
+    GameFree(pool->previousPosition);
+    GameFree(pool->color);
+    GameFree(pool->angle);
+    GameFree(pool->size);
+    GameFree(pool->slot);
+    GameFree(pool->slotIndex);
+    GameFree(pool->generation);
+    GameFree(pool->freeSlots);
+    *pool = (AsteroidPool){ 0 };
+}
 
-    shot->exploded = false;
-    shot->explosionTimer = EXPLOSION_TIME;
-    shot->angle = ship->rotation + 180;
-    Vector2 spawnPos = { 0, ship->length/2 + shot->radius*3 };
-    spawnPos = Vector2Rotate(spawnPos, shot->angle*DEG2RAD);
-    spawnPos = Vector2Add(spawnPos, ship->position);
-    shot->position = spawnPos;
-    shot->despawnTimer = 0.8f;
+void InitMissilePool(MissilePool *pool, unsigned int capacity)
+{
+    *pool = (MissilePool){ .capacity = capacity };
+    pool->position = GameAlloc(capacity*sizeof(Vector2));
+    pool->velocity = GameAlloc(capacity*sizeof(Vector2));
+    pool->radius = GameAlloc(capacity*sizeof(float));
+    pool->flags = GameAlloc(capacity*sizeof(unsigned char));
+    pool->previousPosition = GameAlloc(capacity*sizeof(Vector2));
+    pool->despawnTimer = GameAlloc(capacity*sizeof(float));
+    pool->explosionTimer = GameAlloc(capacity*sizeof(float));
+    pool->liveIds = GameAlloc(capacity*sizeof(unsigned int));
+    pool->hitRock = GameAlloc(capacity*sizeof(unsigned int));
+
+    for (unsigned int i = 0; i < capacity; i++)
+    {
+        pool->radius[i] = MISSILE_RADIUS;
+        pool->flags[i] = ENTITY_EXPLODED; // aka non-existant
+    }
+}
 
-    ship->shotCount++;
-    PlaySound(game.beeps[BEEP_SHOOT]);
+void FreeMissilePool(MissilePool *pool)
+{
+    GameFree(pool->position);
+    GameFree(pool->velocity);
+    GameFree(pool->radius);
+    GameFree(pool->flags);
+    GameFree(pool->previousPosition);
+    GameFree(pool->despawnTimer);
+    GameFree(pool->explosionTimer);
+    GameFree(pool->liveIds);
+    GameFree(pool->hitRock);
+    *pool = (MissilePool){ 0 };
 }
 
-Color ColorBrightnessVariation(Color color)
+unsigned int GetAsteroidIndex(AsteroidHandle handle)
 {
-    float brightness = -0.25f*GetRandomValue(0, 2); // 3 main shades
-    brightness += 0.01f*GetRandomValue(1, 10); // sub-shades
-    color = ColorBrightness(color, brightness);
-    return color;
+    AsteroidPool *pool = &game.rocks;
+    if (handle.slot >= pool->slotsUsed || pool->generation[handle.slot] != handle.generation)
+        return ASTEROID_NONE;
+
+    // Released slots point past the live rocks
+    unsigned int index = pool->slotIndex[handle.slot];
+    if (index >= pool->count)
+        return ASTEROID_NONE;
+
+    return index;
 }
 
-Asteroid *CreateAsteroid(SizeOfAsteroid size, Vector2 position, float angle, Color color)
+void RemoveAsteroid(unsigned int index)
 {
-    game.rockCount++;
-    game.rocks = MemRealloc(game.rocks, game.rockCount*sizeof(Asteroid));
-    Asteroid *rock = &game.rocks[game.rockCount - 1];
-    rock->exploded = false;
-    rock->color = color;
+    AsteroidPool *pool = &game.rocks;
 
-    // radius
-    rock->size = size;
+    // Release the handle slot
+    unsigned int slot = pool->slot[index];
+    pool->generation[slot]++;
+    pool->slotIndex[slot] = ASTEROID_NONE;
+    pool->freeSlots[pool->freeCount++] = slot;
+
+    // Keep the arrays packed by moving the last rock into the gap
+    unsigned int last = --pool->count;
+    if (index != last)
+    {
+        pool->position[index] = pool->position[last];
+        pool->velocity[index] = pool->velocity[last];
+        pool->radius[index] = pool->radius[last];
+        pool->flags[index] = pool->flags[last];
+        pool->previousPosition[index] = pool->previousPosition[last];
+        pool->color[index] = pool->color[last];
+        pool->angle[index] = pool->angle[last];
+        pool->size[index] = pool->size[last];
+        pool->slot[index] = pool->slot[last];
+        pool->slotIndex[pool->slot[index]] = index;
+    }
+}
+
+float GetAsteroidRadius(SizeOfAsteroid size)
+{
     if (size == ASTEROID_SIZE_BIG)
-        rock->radius = ASTEROID_RADIUS_BIG;
+        return ASTEROID_RADIUS_BIG;
     else if (size == ASTEROID_SIZE_MEDIUM)
-        rock->radius = ASTEROID_RADIUS_MEDIUM;
-    else if (size == ASTEROID_SIZE_SMALL)
-        rock->radius = ASTEROID_RADIUS_SMALL;
+        return ASTEROID_RADIUS_MEDIUM;
+    else
+        return ASTEROID_RADIUS_SMALL;
+}
 
-    // position & angle
-    rock->position = position;
-    rock->angle = angle;
+AsteroidHandle CreateAsteroid(SizeOfAsteroid size, Vector2 position, float angle, Color color)
+{
+    AsteroidPool *pool = &game.rocks;
+    if (pool->count == pool->capacity)
+    {
+        TraceLog(LOG_WARNING, "ASTEROIDS: Rock pool is full (%u), spawn dropped", pool->capacity);
+        return (AsteroidHandle){ ASTEROID_NONE, 0 };
+    }
+
+    // Take a released handle slot, or a fresh one
+    unsigned int slot;
+    if (pool->freeCount > 0)
+    {
+        slot = pool->freeSlots[--pool->freeCount];
+        pool->reuseCount++;
+    }
+    else
+    {
+        slot = pool->slotsUsed++;
+        pool->generation[slot] = 0;
+    }
+
+    // Append to the packed arrays
+    unsigned int index = pool->count++;
+    if (pool->count > pool->peakCount)
+        pool->peakCount = pool->count;
+    pool->slot[index] = slot;
+    pool->slotIndex[slot] = index;
+
+    pool->flags[index] = 0;
+    pool->color[index] = color;
+    pool->size[index] = size;
+    pool->radius[index] = GetAsteroidRadius(size);
+    pool->position[index] = position;
+    pool->previousPosition[index] = position;
+    pool->angle[index] = angle;
 
     // Speed proportional to size
     float radiusRange = ASTEROID_RADIUS_BIG - ASTEROID_RADIUS_SMALL;
     float scaledSpeed;
-    scaledSpeed = ASTEROID_SPEED*(ASTEROID_RADIUS_BIG - rock->radius)/radiusRange;
+    scaledSpeed = ASTEROID_SPEED*(ASTEROID_RADIUS_BIG - pool->radius[index])/radiusRange;
     if (scaledSpeed < ASTEROID_SPEED/8) // minimum speed
         scaledSpeed = ASTEROID_SPEED/8;
 
-    rock->speed = scaledSpeed;
+    // Heading never changes, so the velocity is fixed from here on
+    pool->velocity[index] = Vector2Rotate((Vector2){ 0, scaledSpeed }, angle*DEG2RAD);
 
-    return rock;
+    return (AsteroidHandle){ slot, pool->generation[slot] };
 }
 
 void CreateAsteroidRandom(SizeOfAsteroid size)
 {
-    float rockPosX = (float)GetRandomValue(0, VIRTUAL_WIDTH);
-    float rockPosY = (float)GetRandomValue(0, VIRTUAL_HEIGHT);
-    float angle = (float)GetRandomValue(0, 360);
+    RandomStream *random = &game.random[RANDOM_WORLD];
+    float rockPosX = GetRandomFloat(random, 0, VIRTUAL_WIDTH);
+    float rockPosY = GetRandomFloat(random, 0, VIRTUAL_HEIGHT);
+    float angle = GetRandomFloat(random, 0, 360);
     Color colorVariation = ColorBrightnessVariation(BROWN);
 
-    Asteroid *rock = CreateAsteroid(size, (Vector2){ rockPosX, rockPosY }, angle, colorVariation);
+    unsigned int rock = GetAsteroidIndex(CreateAsteroid(size, (Vector2){ rockPosX, rockPosY }, angle, colorVariation));
+    if (rock == ASTEROID_NONE) return; // pool is full
 
+    AsteroidPool *pool = &game.rocks;
     float safeZoneRadius = game.ship.length*3;
-    rock->radius += safeZoneRadius;
+    pool->radius[rock] += safeZoneRadius;
     if (CheckCollisionAsteroidShip(rock, &game.ship))
     {
-        rock->position.x += ((GetRandomValue(0, 1)*2) - 1)*rock->radius*2;
-        rock->position.y += ((GetRandomValue(0, 1)*2) - 1)*rock->radius*2;
+        pool->position[rock].x += ((GetRandomInt(random, 0, 1)*2) - 1)*pool->radius[rock]*2;
+        pool->position[rock].y += ((GetRandomInt(random, 0, 1)*2) - 1)*pool->radius[rock]*2;
+        pool->previousPosition[rock] = pool->position[rock];
     }
-    rock->radius -= safeZoneRadius;
+    pool->radius[rock] -= safeZoneRadius;
 }
 
-void SplitAsteroid(Asteroid *rock)
+void SplitAsteroid(SizeOfAsteroid size, Vector2 position, Color color)
 {
-    float angle = (float)GetRandomValue(0, 180);
-    Vector2 spawnPosA = { 0, rock->radius/2 };
+    float angle = GetRandomFloat(&game.random[RANDOM_GAMEPLAY], 0, 180);
+    Vector2 spawnPosA = { 0, GetAsteroidRadius(size)/2 };
     spawnPosA = Vector2Rotate(spawnPosA, angle*DEG2RAD);
-    Vector2 spawnPosB = Vector2Invert(spawnPosA);
-    spawnPosA = Vector2Add(spawnPosA, rock->position);
-    spawnPosB = Vector2Add(spawnPosB, rock->position);
+    Vector2 spawnPosB = Vector2Negate(spawnPosA); // opposite side of the old rock
+    spawnPosA = Vector2Add(spawnPosA, position);
+    spawnPosB = Vector2Add(spawnPosB, position);
 
-    if (rock->size > ASTEROID_SIZE_SMALL)
+    if (size > ASTEROID_SIZE_SMALL)
     {
-        SizeOfAsteroid splitSize = rock->size - 1;
-        Color splitColor = rock->color;
-        CreateAsteroid(splitSize, spawnPosA, angle, splitColor);
-        CreateAsteroid(splitSize, spawnPosB, angle + 180, splitColor);
+        SizeOfAsteroid splitSize = size - 1;
+        CreateAsteroid(splitSize, spawnPosA, angle, color);
+        CreateAsteroid(splitSize, spawnPosB, angle + 180, color);
     }
 }
 
-bool IsShipOnEdge(SpaceShip *ship)
+void ExplodeAsteroid(unsigned int index)
 {
-    // Check ship
+    // Copy before removing, another rock moves into this index
+    AsteroidPool *pool = &game.rocks;
+    SizeOfAsteroid size = pool->size[index];
+    Vector2 position = pool->position[index];
+    Color color = pool->color[index];
+
+    RemoveAsteroid(index);
+    SplitAsteroid(size, position, color);
+    game.eliminatedCount++;
+    PlayGameBeep(BEEP_EXPLODE);
+}
+
+void ResolveExplodedAsteroids(void)
+{
+    // Pieces are appended past the end and the last rock moves into the gap,
+    // so recheck the same index after each explosion
+    AsteroidPool *pool = &game.rocks;
+    unsigned int i = 0;
+    while (i < pool->count)
+    {
+        if (pool->flags[i] & ENTITY_EXPLODED)
+            ExplodeAsteroid(i);
+        else
+            i++;
+    }
+}
+
+bool CheckCollisionAsteroidShip(unsigned int rock, SpaceShip *ship)
+{
+    Vector2 shipPoints[3];
     for (unsigned int i = 0; i < 3; i++)
     {
-        Vector2 shipPoint = ship->shipPoints[i];
-        Vector2 jetPoint = ship->jetPoints[i];
-        if ((shipPoint.x < 0) || (shipPoint.x > VIRTUAL_WIDTH) ||
-            (shipPoint.y < 0) || (shipPoint.y > VIRTUAL_HEIGHT)||
-            (jetPoint.x < 0) || (jetPoint.x > VIRTUAL_WIDTH) ||
-            (jetPoint.y < 0) || (jetPoint.y > VIRTUAL_HEIGHT))
-                return true; // At least one point is past the edge
+        shipPoints[i] = Vector2Rotate(game.shipTriangle[i], ship->rotation*DEG2RAD);
+        shipPoints[i] = Vector2Add(shipPoints[i], ship->position);
     }
 
-    // Ship is not past edge
-    return false;
+    return CheckCollisionTriangleCircleToroidal(shipPoints, game.rocks.position[rock], game.rocks.radius[rock]);
 }
 
-bool IsCircleOnEdge(Vector2 position, float radius)
+bool CheckCollisionAsteroidMissile(unsigned int rock, unsigned int shot)
 {
-    if ((position.x - radius < 0) ||
-        (position.x + radius > VIRTUAL_WIDTH) ||
-        (position.y - radius < 0) ||
-        (position.y + radius > VIRTUAL_HEIGHT))
-        return true; // Circular object is past the edge
-
-    // Circular object is not past edge
-    return false;
+    return CheckCollisionCirclesToroidal(game.rocks.position[rock], game.rocks.radius[rock],
+                                         game.missiles.position[shot], game.missiles.radius[shot]);
 }
 
-bool CheckCollisionAsteroidShip(Asteroid *rock, SpaceShip *ship)
+void CheckCollisionMissilesAsteroids(void)
 {
-    // Check each point
-    for (unsigned int i = 0; i < 3; i++)
+    AsteroidPool *rocks = &game.rocks;
+    MissilePool *shots = &game.missiles;
+
+    // Missiles look for their rock in parallel...
+    RunParallelFor(CheckMissileChunk, shots, shots->liveCount, MISSILE_JOB_CHUNK);
+
+    // ...and the rocks they hit are flagged here, since two missiles can hit the same one
+    for (unsigned int s = 0; s < shots->liveCount; s++)
     {
-        Vector2 shipPoint = Vector2Rotate(game.shipTriangle[i], ship->rotation*DEG2RAD);
-        shipPoint = Vector2Add(shipPoint, ship->position);
-        if (CheckCollisionPointCircle(shipPoint, rock->position, rock->radius))
-            return true;
+        if (shots->hitRock[s] != ASTEROID_NONE)
+            rocks->flags[shots->hitRock[s]] |= ENTITY_EXPLODED;
     }
 
-    if (rock->isAtScreenEdge)
+    // Before the ship shoots again, ShootMissile() lists a reused slot only if it's off the list
+    DropExplodedMissiles(shots);
+}
+
+void CheckMissileChunk(void *context, unsigned int chunk, unsigned int begin, unsigned int end)
+{
+    MissilePool *shots = context;
+    AsteroidPool *rocks = &game.rocks;
+    CollisionGrid *grid = &game.rockGrid;
+    float deltaTime = SIM_TICK_TIME;
+    (void)chunk;
+
+    for (unsigned int s = begin; s < end; s++)
     {
-        for (unsigned int o = 0; o < 8; o++)
+        unsigned int shot = shots->liveIds[s];
+        shots->hitRock[s] = ASTEROID_NONE;
+        if (shots->flags[shot] & ENTITY_EXPLODED) continue;
+
+        // The missile moved by step this tick, from start to position. Rocks
+        // it could have touched are near the middle of its path, give or take
+        // how far they moved
+        Vector2 position = shots->position[shot];
+        Vector2 step = Vector2Scale(shots->velocity[shot], deltaTime);
+        Vector2 start = Vector2Subtract(position, step);
+        float stepLength = Vector2Length(step);
+        Vector2 middle = Vector2Add(start, Vector2Scale(step, 0.5f));
+        float reach = shots->radius[shot] + stepLength/2 + ASTEROID_SPEED*deltaTime;
+
+        // Only rocks in the cells around the missile can reach it, its own
+        // cell first since it most likely holds the hit. The kernel (see
+        // kernels.h) weeds out the ones nowhere near the path, then the rest
+        // are swept to find the one hit first
+        unsigned int cells[GRID_NEIGHBORS];
+        GetCollisionGridNeighbors(grid, position, cells);
+        unsigned int ownCell = cells[GRID_NEIGHBORS/2];
+        cells[GRID_NEIGHBORS/2] = cells[0];
+        cells[0] = ownCell;
+
+        float firstTime = 2.0f; // past the step until a rock is hit
+        for (unsigned int c = 0; c < GRID_NEIGHBORS && firstTime > 0.0f; c++)
         {
-            Vector2 cloneRockPos = Vector2Add(rock->position, game.wrapOffsets[o]);
-            for (unsigned int i = 0; i < 3; i++)
+            const unsigned int *items = &grid->cellItems[grid->cellStart[cells[c]]];
+            unsigned int itemCount = grid->cellStart[cells[c] + 1] - grid->cellStart[cells[c]];
+            for (unsigned int k = 0; k < itemCount && firstTime > 0.0f; k += KERNEL_MAX_BATCH)
             {
-                Vector2 shipPoint = Vector2Rotate(game.shipTriangle[i], ship->rotation*DEG2RAD);
-                shipPoint = Vector2Add(shipPoint, ship->position);
-                if (CheckCollisionPointCircle(shipPoint, cloneRockPos, rock->radius))
-                    return true;
+                unsigned int batch = (itemCount - k < KERNEL_MAX_BATCH)? itemCount - k : KERNEL_MAX_BATCH;
+                unsigned int near = CheckCirclesToroidal(middle, reach, rocks->position, rocks->radius, &items[k], batch);
+                for (unsigned int j = k; near != 0; j++, near >>= 1)
+                {
+                    if (!(near & 1)) continue;
+
+                    unsigned int rock = items[j];
+                    Vector2 motion = Vector2Subtract(step, Vector2Scale(rocks->velocity[rock], deltaTime));
+                    float time;
+                    if (!CheckCollisionSweptCirclesToroidal(rocks->position[rock], rocks->radius[rock],
+                                                            position, shots->radius[shot], motion, &time) ||
+                        time >= firstTime)
+                        continue;
+
+                    // Only rocks hit sooner can beat this one, so the rest
+                    // of the search only covers the path up to here
+                    firstTime = time;
+                    shots->hitRock[s] = rock;
+                    middle = Vector2Add(start, Vector2Scale(step, time*0.5f));
+                    reach = shots->radius[shot] + stepLength*time/2 + ASTEROID_SPEED*deltaTime;
+                    if (time == 0.0f) break; // can't beat touching from the start
+                }
             }
         }
-    }
 
-    return false;
+        // Explode where it touched the rock
+        if (shots->hitRock[s] != ASTEROID_NONE)
+        {
+            shots->flags[shot] |= ENTITY_EXPLODED;
+            shots->position[shot] = Vector2Subtract(position, Vector2Scale(step, 1.0f - firstTime));
+            WrapPastEdge(&shots->position[shot]);
+        }
+    }
 }
 
+#if !defined(PLATFORM_HEADLESS) // menus need the UI
 void UpdateGameFrame(void)
 {
     if (IsInputActionPressed(INPUT_ACTION_BACK))
     {
         ChangeUiMenu(UI_MENU_TITLE);
-        PlaySound(game.beeps[BEEP_MENU]);
+        PlayGameBeep(BEEP_MENU);
         return; // back to main game loop: UpdateDrawFrame()
     }
 
-    // Detect win state and reset asteroids
-    if (game.rockCount == game.eliminatedCount)
-    {
-        game.rockCount = 0;
-        game.eliminatedCount = 0;
-        for (unsigned int i = 0; i < ASTEROID_COUNT; i++)
-        {
-            CreateAsteroidRandom(ASTEROID_SIZE_BIG);
-        }
-    }
-
     if (IsInputActionPressed(INPUT_ACTION_PAUSE))
     {
         game.isPaused = !game.isPaused;
@@ -322,29 +508,49 @@ void UpdateGameFrame(void)
             ChangeUiMenu(UI_MENU_PAUSE);
         else
             ui.currentMenu = UI_MENU_GAMEPLAY;
-        PlaySound(game.beeps[BEEP_MENU]);
+        PlayGameBeep(BEEP_MENU);
     }
 
-    if (!game.isPaused)
-    {
-        // Update rocks
-        for (unsigned int i = 0; i < game.rockCount; i++)
-        {
-            UpdateAsteroid(&game.rocks[i]);
-        }
+    // Update user interface elements and logic
+    UpdateUiFrame();
+}
+#endif
 
-        // Update bullets
-        for (unsigned int i = 0; i < MISSILE_MAX; i++)
+void UpdateGameTick(void)
+{
+    // Detect win state and reset asteroids
+    if (game.rocks.count == 0)
+    {
+        for (unsigned int i = 0; i < ASTEROID_COUNT; i++)
         {
-            UpdateMissile(&game.ship.missiles[i]);
+            CreateAsteroidRandom(ASTEROID_SIZE_BIG);
         }
-
-        // Update ship
-        UpdateShip(&game.ship);
     }
 
-    // Update user interface elements and logic
-    UpdateUiFrame();
+    // Remember where everything was for interpolated drawing, rocks do it as they move
+    memcpy(game.missiles.previousPosition, game.missiles.position, game.missiles.capacity*sizeof(Vector2));
+    game.ship.previousPosition = game.ship.position;
+    game.ship.previousRotation = game.ship.rotation;
+
+    // Update rocks and bullets, each phase spread over the job system's
+    // threads and done before the next one starts
+    PROFILE_BEGIN(PROFILE_ZONE_UPDATE_ASTEROIDS);
+    UpdateAsteroids();
+    PROFILE_END(PROFILE_ZONE_UPDATE_ASTEROIDS);
+    PROFILE_BEGIN(PROFILE_ZONE_UPDATE_MISSILES);
+    UpdateMissiles();
+    PROFILE_END(PROFILE_ZONE_UPDATE_MISSILES);
+    PROFILE_BEGIN(PROFILE_ZONE_COLLISION);
+    CheckCollisionMissilesAsteroids(); // both have moved, sweeps the whole step
+    PROFILE_END(PROFILE_ZONE_COLLISION);
+
+    // The ship and the rocks' explosions are one writer each, they stay on this thread
+    PROFILE_BEGIN(PROFILE_ZONE_UPDATE_SHIP);
+    UpdateShip(&game.ship);
+    PROFILE_END(PROFILE_ZONE_UPDATE_SHIP);
+
+    // Rock indices in the grid stay valid until here
+    ResolveExplodedAsteroids();
 }
 
 void WrapPastEdge(Vector2 *position)
@@ -363,12 +569,13 @@ void UpdateShip(SpaceShip *ship)
 {
     if (ship->exploded)
     {
-        game.ship.respawnTimer -= GetFrameTime();
+        game.ship.respawnTimer -= SIM_TICK_TIME;
 
         if (game.ship.respawnTimer <= EPSILON)
         {
             game.ship.exploded = false;
             game.ship.position = (Vector2){ VIRTUAL_WIDTH/2, VIRTUAL_HEIGHT/2 };
+            game.ship.previousPosition = game.ship.position;
             game.ship.velocity = (Vector2){ 0, 0 };
             game.ship.respawnTimer = SHIP_RESPAWN_TIME;
             UpdateShip(ship);
@@ -379,51 +586,77 @@ void UpdateShip(SpaceShip *ship)
     }
 
     // Player Input
+    TickInput *input = &game.input;
+    ship->isThrusting = IsTickActionDown(input, INPUT_ACTION_FORWARD);
+
     // Rotate (mouse)
-    if ((Vector2Length(GetMouseDelta()) != 0) ||
-        IsMouseButtonDown(MOUSE_LEFT_BUTTON) || IsMouseButtonDown(MOUSE_RIGHT_BUTTON))
+    if (input->mouseMoved || input->mouseLeftDown || input->mouseRightDown)
     {
-        Vector2 mousePos = GetScaledMousePosition();
-        Vector2 mouseDirection = Vector2Subtract(mousePos, ship->position);
+        Vector2 mouseDirection = Vector2Subtract(input->mousePosition, ship->position);
         float distanceToMouse = Vector2Length(mouseDirection);
-        if ((IsInputActionDown(INPUT_ACTION_FORWARD) && distanceToMouse > ship->length) ||
-            !IsInputActionDown(INPUT_ACTION_FORWARD) || IsMouseButtonDown(MOUSE_RIGHT_BUTTON))
+        if ((ship->isThrusting && distanceToMouse > ship->length) ||
+            !ship->isThrusting || input->mouseRightDown)
             ship->rotation = (float)atan2(mouseDirection.y, mouseDirection.x)*RAD2DEG + 90;
     }
     // Rotate (keys)
-    if (IsInputActionDown(INPUT_ACTION_LEFT))
+    if (IsTickActionDown(input, INPUT_ACTION_LEFT))
     {
-        ship->rotation -= SHIP_TURN_SPEED*GetFrameTime();
+        ship->rotation -= SHIP_TURN_SPEED*SIM_TICK_TIME;
     }
-    if (IsInputActionDown(INPUT_ACTION_RIGHT))
+    if (IsTickActionDown(input, INPUT_ACTION_RIGHT))
     {
-        ship->rotation += SHIP_TURN_SPEED*GetFrameTime();
+        ship->rotation += SHIP_TURN_SPEED*SIM_TICK_TIME;
     }
 
     // Calculate thrust amount
-    if (IsInputActionDown(INPUT_ACTION_FORWARD))
+    if (ship->isThrusting)
     {
         Vector2 thrust = (Vector2){ 0, -SHIP_THRUST_SPEED };
         thrust = Vector2Rotate(thrust, ship->rotation*DEG2RAD);
-        thrust = Vector2Scale(thrust, GetFrameTime());
+        thrust = Vector2Scale(thrust, SIM_TICK_TIME);
         ship->velocity = Vector2Add(ship->velocity, thrust);
         ship->velocity = Vector2ClampValue(ship->velocity, 0, SHIP_MAX_SPEED);
     }
 
-    if (IsInputActionPressed(INPUT_ACTION_SHOOT))
+    if (IsTickActionPressed(input, INPUT_ACTION_SHOOT))
     {
         ShootMissile(ship);
     }
 
     // Apply friction (smooth exponential decay)
-    float slowdown = expf(-SPACE_FRICTION/10*GetFrameTime());
+    float slowdown = expf(-SPACE_FRICTION/10*SIM_TICK_TIME);
     ship->velocity = Vector2Scale(ship->velocity, slowdown);
 
     // Update position
-    Vector2 scaledVelocity = Vector2Scale(ship->velocity, GetFrameTime());
+    Vector2 scaledVelocity = Vector2Scale(ship->velocity, SIM_TICK_TIME);
     ship->position = Vector2Add(ship->position, scaledVelocity);
 
     // Calculate new triangle points for collision & screen wrap
+    UpdateShipPoints(ship);
+    WrapPastEdge(&ship->position);
+
+
+    // Check collision with asteroids around the ship
+    CollisionGrid *grid = &game.rockGrid;
+    unsigned int cells[GRID_NEIGHBORS];
+    GetCollisionGridNeighbors(grid, ship->position, cells);
+    for (unsigned int c = 0; c < GRID_NEIGHBORS; c++)
+    {
+        for (unsigned int k = grid->cellStart[cells[c]]; k < grid->cellStart[cells[c] + 1]; k++)
+        {
+            unsigned int rock = grid->cellItems[k];
+            if (game.rocks.flags[rock] & ENTITY_EXPLODED) continue; // shot this tick, gone once resolved
+            if (CheckCollisionAsteroidShip(rock, ship))
+            {
+                ship->exploded = true;
+                game.rocks.flags[rock] |= ENTITY_EXPLODED;
+            }
+        }
+    }
+}
+
+void UpdateShipPoints(SpaceShip *ship)
+{
     for (unsigned int i = 0; i < 3; i++)
     {
         ship->shipPoints[i] = Vector2Rotate(game.shipTriangle[i], ship->rotation*DEG2RAD);
@@ -431,192 +664,216 @@ void UpdateShip(SpaceShip *ship)
         ship->jetPoints[i] = Vector2Rotate(game.jetTriangle[i], (ship->rotation+180)*DEG2RAD);
         ship->jetPoints[i] = Vector2Add(ship->jetPoints[i], ship->position);
     }
+}
 
-    ship->isAtScreenEdge = IsShipOnEdge(ship);
-    WrapPastEdge(&ship->position);
+void UpdateAsteroids(void)
+{
+    AsteroidPool *rocks = &game.rocks;
 
+    // Update positions
+    RunParallelFor(MoveAsteroidChunk, rocks, rocks->count, ASTEROID_JOB_CHUNK);
 
-    // Check collision with asteroids
-    for (unsigned int i = 0; i < game.rockCount; i++)
-    {
-        Asteroid *rock = &game.rocks[i];
-        if (!rock->exploded && CheckCollisionAsteroidShip(rock, &game.ship))
-        {
-            game.ship.exploded = true;
-            rock->exploded = true;
-            SplitAsteroid(rock);
-            game.eliminatedCount++;
-            PlaySound(game.beeps[BEEP_EXPLODE]);
-        }
-    }
+    // Bucket the rocks for this frame's collision checks
+    BuildCollisionGrid(&game.rockGrid, rocks->position, rocks->count);
 }
 
-void UpdateAsteroid(Asteroid *rock)
+void MoveAsteroidChunk(void *context, unsigned int chunk, unsigned int begin, unsigned int end)
 {
-    if (rock->exploded) return;
+    AsteroidPool *rocks = context;
+    (void)chunk;
 
-    // Update position
-    Vector2 currentVelocity = (Vector2){ 0, rock->speed*GetFrameTime() };
-    currentVelocity = Vector2Rotate(currentVelocity, rock->angle*DEG2RAD);
-    rock->position = Vector2Add(rock->position, currentVelocity);
-    rock->isAtScreenEdge = IsCircleOnEdge(rock->position, rock->radius);
-    WrapPastEdge(&rock->position);
-
-    // Check collision with missiles
-    for (unsigned int i = 0; i < MISSILE_MAX; i++)
-    {
-        Missile *shot = &game.ship.missiles[i];
-        if (!shot->exploded && CheckCollisionCircles(rock->position, rock->radius,
-                                                     shot->position, shot->radius))
-        {
-            rock->exploded = true;
-            shot->exploded = true;
-        }
+    memcpy(&rocks->previousPosition[begin], &rocks->position[begin], (end - begin)*sizeof(Vector2));
+    MoveCircles(&rocks->position[begin], &rocks->velocity[begin], end - begin, SIM_TICK_TIME);
+}
 
-        if (rock->isAtScreenEdge)
-        {
-            for (unsigned int o = 0; o < 8; o++)
-            {
-                Vector2 cloneRockPos = Vector2Add(rock->position, game.wrapOffsets[o]);
-                if (!shot->exploded && CheckCollisionCircles(cloneRockPos, rock->radius,
-                                                             shot->position, shot->radius))
-                {
-                    rock->exploded = true;
-                    shot->exploded = true;
-                }
-            }
-        }
-    }
+void UpdateMissiles(void)
+{
+    MissilePool *shots = &game.missiles;
+    float deltaTime = SIM_TICK_TIME;
 
-    if (rock->exploded)
+    // Explosion flashes
+    for (unsigned int i = 0; i < shots->capacity; i++)
     {
-        game.eliminatedCount++;
-        SplitAsteroid(rock);
-        PlaySound(game.beeps[BEEP_EXPLODE]);
+        if (shots->flags[i] & ENTITY_EXPLODED)
+            shots->explosionTimer[i] -= deltaTime;
     }
+
+    // Move the missiles in flight and drop the ones that ran out of time.
+    // The ones that hit a rock were dropped by CheckCollisionMissilesAsteroids()
+    RunParallelFor(MoveMissileChunk, shots, shots->liveCount, MISSILE_JOB_CHUNK);
+    DropExplodedMissiles(shots);
 }
 
-void UpdateMissile(Missile *shot)
+void DropExplodedMissiles(MissilePool *pool)
 {
-    if (shot->exploded)
+    unsigned int liveCount = 0;
+    for (unsigned int s = 0; s < pool->liveCount; s++)
     {
-        shot->explosionTimer -= GetFrameTime();
-        return;
+        unsigned int i = pool->liveIds[s];
+        if (!(pool->flags[i] & ENTITY_EXPLODED))
+            pool->liveIds[liveCount++] = i;
     }
+    pool->liveCount = liveCount;
+}
 
-    // Update position
-    Vector2 currentVelocity = (Vector2){ 0, shot->speed*GetFrameTime() };
-    currentVelocity = Vector2Rotate(currentVelocity, shot->angle*DEG2RAD);
-    shot->position = Vector2Add(shot->position, currentVelocity);
-    shot->isAtScreenEdge = IsCircleOnEdge(shot->position, shot->radius);
-    WrapPastEdge(&shot->position);
+void MoveMissileChunk(void *context, unsigned int chunk, unsigned int begin, unsigned int end)
+{
+    MissilePool *shots = context;
+    float deltaTime = SIM_TICK_TIME;
+    (void)chunk;
+
+    MoveCirclesIndexed(shots->position, shots->velocity, &shots->liveIds[begin], end - begin, deltaTime);
 
-    // Update despawn timer
-    shot->despawnTimer -= GetFrameTime();
-    if (shot->despawnTimer <= 0)
+    // Update despawn timers
+    for (unsigned int s = begin; s < end; s++)
     {
-        shot->exploded = true;
-        shot->explosionTimer = 0.0f;
+        unsigned int i = shots->liveIds[s];
+        shots->despawnTimer[i] -= deltaTime;
+        if (shots->despawnTimer[i] <= 0)
+        {
+            shots->flags[i] |= ENTITY_EXPLODED;
+            shots->explosionTimer[i] = 0.0f;
+        }
     }
 }
 
+#if !defined(PLATFORM_HEADLESS) // nothing to draw to
 void DrawGameFrame(void)
 {
     // Draw stars
-    for (unsigned int i = 0; i < STAR_AMOUNT; i++)
-        DrawCircleV(game.stars[i], 1.0f, WHITE);
+    DrawStarField();
 
-    // Draw rocks
-    for (unsigned int i = 0; i < game.rockCount; i++)
-    {
-        Asteroid *rock = &game.rocks[i];
-        if (!rock->exploded)
-            DrawAsteroid(rock);
-    }
-
-    // Draw missiles
-    for (unsigned int i = 0; i < MISSILE_MAX; i++)
-    {
-        Missile *shot = &game.ship.missiles[i];
-        if (!shot->exploded)
-            DrawMissile(shot);
-        else if (shot->explosionTimer > EPSILON)
-            DrawCircleV(shot->position, shot->radius*5, Fade(RED, 0.5f));
-    }
+    // Draw rocks, then missiles and their explosions, each all in one draw
+    // call (see render.h) before the ship goes over them
+    DrawAsteroids();
+    DrawRockBatch();
+    DrawMissiles();
+    DrawCircleBatch();
 
     // Draw ship
     if (!game.ship.exploded)
         DrawShip(&game.ship);
     else if ((SHIP_RESPAWN_TIME - game.ship.respawnTimer) < EXPLOSION_TIME)
-        DrawCircleV(game.ship.position, game.ship.length, Fade(RED, 0.5f));
+    {
+        QueueCircle(game.ship.position, game.ship.length, Fade(RED, 0.5f));
+        DrawCircleBatch();
+    }
 
     // Draw user interface elements
+    PROFILE_BEGIN(PROFILE_ZONE_DRAW_UI_FRAME);
     DrawUiFrame();
+    PROFILE_END(PROFILE_ZONE_DRAW_UI_FRAME);
+}
+
+Vector2 InterpolatePosition(Vector2 previous, Vector2 current)
+{
+    // Start from the clone of the previous position nearest the current one,
+    // so objects that wrapped last tick don't sweep across the screen
+    Vector2 from = Vector2Add(previous, GetWrapOffset(previous, current));
+    return Vector2Lerp(from, current, game.tickAlpha);
 }
 
 void DrawShip(SpaceShip *ship)
 {
-    // Get and transform ship triangle + jet triangle
-    DrawTriangle(ship->shipPoints[0], ship->shipPoints[1], ship->shipPoints[2], GRAY);
-    if (IsInputActionDown(INPUT_ACTION_FORWARD))
-        DrawTriangle(ship->jetPoints[0], ship->jetPoints[1], ship->jetPoints[2], Fade(ORANGE, 0.5f));
+    // Get and transform ship triangle + jet triangle between the last two ticks
+    SpaceShip drawn = *ship;
+    float turn = fmodf(ship->rotation - ship->previousRotation + 540.0f, 360.0f) - 180.0f; // shortest way around
+    drawn.rotation = ship->previousRotation + turn*game.tickAlpha;
+    drawn.position = InterpolatePosition(ship->previousPosition, ship->position);
+    UpdateShipPoints(&drawn);
+
+    DrawTriangle(drawn.shipPoints[0], drawn.shipPoints[1], drawn.shipPoints[2], GRAY);
+    if (ship->isThrusting)
+    {
+        DrawTriangle(drawn.jetPoints[0], drawn.jetPoints[1], drawn.jetPoints[2], Fade(ORANGE, 0.5f));
+        LATENCY_SUBMIT(LATENCY_THRUST, 0);
+    }
 
-    // Clones at opposite side of screen
-    if (ship->isAtScreenEdge)
+    // Clones at opposite side of screen, only the ones the ship + jet reach into
+    Vector2 min = drawn.shipPoints[0];
+    Vector2 max = drawn.shipPoints[0];
+    for (unsigned int i = 0; i < 3; i++)
     {
-        for (unsigned int i = 0; i < 8; i++)
-        {
-            Vector2 cloneShip[3];
-            Vector2 cloneJet[3];
-            cloneShip[0] = Vector2Add(ship->shipPoints[0], game.wrapOffsets[i]);
-            cloneShip[1] = Vector2Add(ship->shipPoints[1], game.wrapOffsets[i]);
-            cloneShip[2] = Vector2Add(ship->shipPoints[2], game.wrapOffsets[i]);
-            cloneJet[0] = Vector2Add(ship->jetPoints[0], game.wrapOffsets[i]);
-            cloneJet[1] = Vector2Add(ship->jetPoints[1], game.wrapOffsets[i]);
-            cloneJet[2] = Vector2Add(ship->jetPoints[2], game.wrapOffsets[i]);
-
-            DrawTriangle(cloneShip[0], cloneShip[1], cloneShip[2], GRAY);
-            if (IsInputActionDown(INPUT_ACTION_FORWARD))
-                DrawTriangle(cloneJet[0], cloneJet[1], cloneJet[2], Fade(ORANGE, 0.5f));
-        }
+        min = Vector2Min(min, Vector2Min(drawn.shipPoints[i], drawn.jetPoints[i]));
+        max = Vector2Max(max, Vector2Max(drawn.shipPoints[i], drawn.jetPoints[i]));
+    }
+    Vector2 offsets[WRAP_MAX_CLONES];
+    unsigned int cloneCount = GetWrapClones((Rectangle){ min.x, min.y, max.x - min.x, max.y - min.y }, offsets);
+    PROFILE_COUNT(PROFILE_COUNTER_WRAP_CLONES, cloneCount);
+    for (unsigned int i = 0; i < cloneCount; i++)
+    {
+        Vector2 cloneShip[3];
+        Vector2 cloneJet[3];
+        cloneShip[0] = Vector2Add(drawn.shipPoints[0], offsets[i]);
+        cloneShip[1] = Vector2Add(drawn.shipPoints[1], offsets[i]);
+        cloneShip[2] = Vector2Add(drawn.shipPoints[2], offsets[i]);
+        cloneJet[0] = Vector2Add(drawn.jetPoints[0], offsets[i]);
+        cloneJet[1] = Vector2Add(drawn.jetPoints[1], offsets[i]);
+        cloneJet[2] = Vector2Add(drawn.jetPoints[2], offsets[i]);
+
+        DrawTriangle(cloneShip[0], cloneShip[1], cloneShip[2], GRAY);
+        if (ship->isThrusting)
+            DrawTriangle(cloneJet[0], cloneJet[1], cloneJet[2], Fade(ORANGE, 0.5f));
     }
 }
 
-void DrawAsteroid(Asteroid *rock)
+void DrawAsteroids(void)
 {
-    DrawCircleV((Vector2){ rock->position.x, rock->position.y }, rock->radius, rock->color);
-
-    // Clones at opposite side of screen
-    if (rock->isAtScreenEdge)
+    AsteroidPool *rocks = &game.rocks;
+    for (unsigned int i = 0; i < rocks->count; i++)
     {
-        for (unsigned int i = 0; i < 8; i++)
+        Vector2 position = InterpolatePosition(rocks->previousPosition[i], rocks->position[i]);
+        unsigned int shape = GetRockShape(rocks->size[i], rocks->slot[i]);
+        QueueRock(shape, position, rocks->radius[i], rocks->angle[i], rocks->color[i]);
+
+        // Clones at opposite side of screen
+        float radius = rocks->radius[i];
+        Vector2 offsets[WRAP_MAX_CLONES];
+        unsigned int cloneCount = GetWrapClones((Rectangle){ position.x - radius, position.y - radius, radius*2, radius*2 }, offsets);
+        PROFILE_COUNT(PROFILE_COUNTER_WRAP_CLONES, cloneCount);
+        for (unsigned int o = 0; o < cloneCount; o++)
         {
-            Vector2 cloneAsteroid = Vector2Add(rock->position, game.wrapOffsets[i]);
-            DrawCircleV((Vector2){ cloneAsteroid.x, cloneAsteroid.y }, rock->radius, rock->color);
+            Vector2 cloneAsteroid = Vector2Add(position, offsets[o]);
+            QueueRock(shape, cloneAsteroid, radius, rocks->angle[i], rocks->color[i]);
         }
     }
 }
 
-void DrawMissile(Missile *shot)
+void DrawMissiles(void)
 {
-    if (shot->exploded) return;
+    MissilePool *shots = &game.missiles;
+    for (unsigned int i = 0; i < shots->capacity; i++)
+    {
+        if (shots->flags[i] & ENTITY_EXPLODED)
+        {
+            if (shots->explosionTimer[i] > EPSILON)
+                QueueCircle(shots->position[i], shots->radius[i]*5, Fade(RED, 0.5f));
+            continue;
+        }
 
-    DrawCircleV((Vector2){ shot->position.x, shot->position.y }, shot->radius, RAYWHITE);
+        Vector2 position = InterpolatePosition(shots->previousPosition[i], shots->position[i]);
+        QueueCircle(position, shots->radius[i], RAYWHITE);
+        LATENCY_SUBMIT(LATENCY_SHOOT, i);
 
-    // Clones at opposite side of screen
-    if (shot->isAtScreenEdge)
-    {
-        for (unsigned int i = 0; i < 8; i++)
+        // Clones at opposite side of screen
+        float radius = shots->radius[i];
+        Vector2 offsets[WRAP_MAX_CLONES];
+        unsigned int cloneCount = GetWrapClones((Rectangle){ position.x - radius, position.y - radius, radius*2, radius*2 }, offsets);
+        PROFILE_COUNT(PROFILE_COUNTER_WRAP_CLONES, cloneCount);
+        for (unsigned int o = 0; o < cloneCount; o++)
         {
-            Vector2 cloneAsteroid = Vector2Add(shot->position, game.wrapOffsets[i]);
-            DrawCircleV((Vector2){ cloneAsteroid.x, cloneAsteroid.y }, shot->radius, RAYWHITE);
+            Vector2 cloneMissile = Vector2Add(position, offsets[o]);
+            QueueCircle(cloneMissile, radius, RAYWHITE);
         }
     }
 }
+#endif
 
 void ResetShip(SpaceShip *ship)
 {
     ship->position.x = VIRTUAL_WIDTH/2;
     ship->position.y = VIRTUAL_HEIGHT/2;
-    ship->rotation = (float)GetRandomValue(0, 360);
+    ship->rotation = GetRandomFloat(&game.random[RANDOM_GAMEPLAY], 0, 360);
+    ship->previousPosition = ship->position;
+    ship->previousRotation = ship->rotation;
 }
@@ -5,6 +5,10 @@
 #define ASTEROIDS_GAME_HEADER_GUARD
 
 #include "raylib.h"
+#include "collision.h"
+#include "config.h"
+#include "input.h"
+#include "random.h"
 
 // Macros
 // ----------------------------------------------------------------------------
@@ -20,15 +24,21 @@
 #define MISSILE_MAX 10
 #define MISSILE_RADIUS 5.0f
 #define MISSILE_SPEED 1100.0f
+#define MISSILE_JOB_CHUNK 32 // missiles per job chunk, each one searches a 3x3 block of the grid
 
 #define ASTEROID_COUNT 4
 #define ASTEROID_RADIUS_BIG 80
 #define ASTEROID_RADIUS_MEDIUM 40
 #define ASTEROID_RADIUS_SMALL 20
 #define ASTEROID_SPEED 300.0f
+#define ASTEROID_POOL_SIZE 64 // rock slots reserved up front, a wave never reallocates
+#define ASTEROID_NONE 0xFFFFFFFFu // invalid packed index
+#define MISSILE_SWEEP_REACH (ASTEROID_RADIUS_BIG + MISSILE_RADIUS + (MISSILE_SPEED + ASTEROID_SPEED)*SIM_TICK_TIME) // farthest a rock a missile hit during a tick can end up from it
+#define ASTEROID_GRID_CELL_SIZE ((ASTEROID_RADIUS_BIG*2 > MISSILE_SWEEP_REACH)? ASTEROID_RADIUS_BIG*2 : MISSILE_SWEEP_REACH) // covers the reach of the biggest rock
+#define ASTEROID_JOB_CHUNK 2048 // rocks moved per job chunk
 
 #define EXPLOSION_TIME 0.4f
-#define STAR_AMOUNT 800
+#define STAR_AMOUNT 800 // baked into a texture, so tens of thousands cost no more to draw
 
 // Types and Structures
 // ----------------------------------------------------------------------------
@@ -45,63 +55,106 @@ typedef enum GameBeep {
     BEEP_MENU, BEEP_SHOOT, BEEP_EXPLODE
 } GameBeep;
 
+typedef enum EntityFlags {
+    ENTITY_EXPLODED = 1 << 0,
+} EntityFlags;
+
 typedef enum SizeOfAsteroid {
     ASTEROID_SIZE_SMALL,
     ASTEROID_SIZE_MEDIUM,
     ASTEROID_SIZE_BIG,
 } SizeOfAsteroid;
 
-typedef struct Asteroid {
-    Color color;
-    Vector2 position;
-    Vector2 velocity;
-    float angle;
-    float speed;
-    float radius;
-    SizeOfAsteroid size;
-    bool isAtScreenEdge;
-    bool exploded;
-} Asteroid;
-
-typedef struct Missile {
-    Vector2 position;
-    Vector2 velocity;
-    float angle;
-    float speed;
-    float radius;
-    float despawnTimer;
-    float explosionTimer;
-    bool isAtScreenEdge;
-    bool exploded;
-} Missile;
+// Refers to a rock in the pool
+// Stays valid while the rock moves around in the packed arrays,
+// and is detected as stale once the rock is gone and its slot reused
+typedef struct AsteroidHandle {
+    unsigned int slot;
+    unsigned int generation;
+} AsteroidHandle;
+
+// Fixed-capacity structure-of-arrays storage for rocks
+// Live rocks are packed in [0, count) so per-frame passes walk each array linearly,
+// removing a rock moves the last one into its place
+typedef struct AsteroidPool {
+    // Hot data, touched every frame
+    Vector2 *position;
+    Vector2 *velocity; // per second, fixed at spawn
+    float *radius;
+    unsigned char *flags; // EntityFlags
+
+    // Cold data, touched on spawn/split/draw
+    Vector2 *previousPosition; // as of the last tick, for interpolated drawing
+    Color *color;
+    float *angle;
+    SizeOfAsteroid *size;
+    unsigned int *slot; // live-index list: packed index -> handle slot
+
+    // Handle slots
+    unsigned int *slotIndex; // handle slot -> packed index
+    unsigned int *generation;
+    unsigned int *freeSlots; // stack of released handle slots
+
+    unsigned int capacity;
+    unsigned int count; // live rocks
+    unsigned int slotsUsed; // handle slots handed out at least once
+    unsigned int freeCount;
+    unsigned int peakCount;  // for sizing ASTEROID_POOL_SIZE
+    unsigned int reuseCount; // spawns served from the free list
+} AsteroidPool;
+
+// Structure-of-arrays storage for missiles
+// Slots are reused in a ring (oldest shot first), the ones in flight are listed in liveIds
+typedef struct MissilePool {
+    // Hot data, touched every frame
+    Vector2 *position;
+    Vector2 *velocity; // per second, fixed when shot
+    float *radius;
+    unsigned char *flags; // EntityFlags
+
+    // Cold data
+    Vector2 *previousPosition; // as of the last tick, for interpolated drawing
+    float *despawnTimer;
+    float *explosionTimer;
+
+    unsigned int *liveIds; // slots of missiles in flight
+    unsigned int *hitRock; // rock each of liveIds hit in the last collision check or ASTEROID_NONE, scratch
+    unsigned int liveCount;
+    unsigned int capacity;
+    unsigned int nextShot;
+} MissilePool;
 
 typedef struct SpaceShip {
-    Missile missiles[MISSILE_MAX];
     Vector2 position;
+    Vector2 previousPosition; // as of the last tick, for interpolated drawing
     Vector2 shipPoints[3];
     Vector2 jetPoints[3];
     Vector2 velocity;
     float rotation; // in degrees, 0 is pointing up, 90 is right
+    float previousRotation;
     float width;
     float length;
     float respawnTimer;
-    unsigned int shotCount;
-    bool isAtScreenEdge;
+    bool isThrusting;
     bool exploded;
 } SpaceShip;
 
 typedef struct GameState {
-    Sound beeps[3];
     Camera2D camera;
     SpaceShip ship;
-    Asteroid *rocks;
+    AsteroidPool rocks;
+    MissilePool missiles;
+    CollisionGrid rockGrid; // rebuilt every tick after the rocks move
+    TickInput input;        // player input for the next tick
+    float tickAccumulator;  // frame time not yet simulated
+    float tickAlpha;        // how far drawing is between the last two ticks, 0 to 1
     GameMode currentMode;
     Vector2 stars[STAR_AMOUNT];
     Vector2 shipTriangle[3];
     Vector2 jetTriangle[3];
-    Vector2 wrapOffsets[8];
     ScreenState currentScreen;
-    unsigned int rockCount;
+    unsigned int seed;      // random seed the session started from, see replay.h
+    RandomStream random[RANDOM_STREAM_COUNT]; // all seeded from seed
     unsigned int eliminatedCount;
     // unsigned int scoreL;
     // unsigned int scoreR;
@@ -116,34 +169,49 @@ extern GameState game; // global declaration
 // ----------------------------------------------------------------------------
 
 // Initialization
-void InitGameState(void); // Initialize game data and allocate memory for beeps
-Sound GenBeep(float freq, float lengthSec); // Generate and allocate memory a sine wave buffer for a beep
+void InitGameState(unsigned int seed); // Initialize game data and allocate memory for entities
+                                       // Seeds game.random, the same seed and input replay the same session
 void FreeGameState(void); // Free any allocated memory within game state
 
+// Entity Pools
+void InitAsteroidPool(AsteroidPool *pool, unsigned int capacity); // Allocate all rock arrays up front
+void FreeAsteroidPool(AsteroidPool *pool);
+void InitMissilePool(MissilePool *pool, unsigned int capacity);
+void FreeMissilePool(MissilePool *pool);
+unsigned int GetAsteroidIndex(AsteroidHandle handle); // Returns ASTEROID_NONE if the rock is gone
+void RemoveAsteroid(unsigned int index); // Moves the last rock into index
+
 // Create/Destroy Entities
 void ShootMissile(SpaceShip *ship);
 Color ColorBrightnessVariation(Color color);
-Asteroid *CreateAsteroid(SizeOfAsteroid size, Vector2 position, float angle, Color color);
+float GetAsteroidRadius(SizeOfAsteroid size);
+AsteroidHandle CreateAsteroid(SizeOfAsteroid size, Vector2 position, float angle, Color color);
 void CreateAsteroidRandom(SizeOfAsteroid size);
-void SplitAsteroid(Asteroid *rock);
+void SplitAsteroid(SizeOfAsteroid size, Vector2 position, Color color);
+void ExplodeAsteroid(unsigned int index); // Remove a rock and spawn its pieces
+void ResolveExplodedAsteroids(void); // Explode every rock flagged ENTITY_EXPLODED
 
 // Collision
-bool IsShipOnEdge(SpaceShip *ship);
-bool IsCircleOnEdge(Vector2 position, float radius);
-bool CheckCollisionAsteroidShip(Asteroid *rock, SpaceShip *ship);
+bool CheckCollisionAsteroidShip(unsigned int rock, SpaceShip *ship);
+bool CheckCollisionAsteroidMissile(unsigned int rock, unsigned int shot);
+void CheckCollisionMissilesAsteroids(void); // Flags rocks and missiles that hit each other during the tick, in parallel
+                                            // Missiles are swept, so they can't pass through a rock between ticks
 
 // Update & User Input
-void UpdateGameFrame(void); // Updates all the game's data and objects for the current frame
+void UpdateGameFrame(void); // Handles menus and pausing for the current frame
+void UpdateGameTick(void);  // Steps the simulation by SIM_TICK_TIME
 void WrapPastEdge(Vector2 *position);
-void UpdateAsteroid(Asteroid *rock);
-void UpdateMissile(Missile *shot);
+void UpdateAsteroids(void); // Move every rock and rebuild the rock grid, in parallel
+void UpdateMissiles(void); // Move missiles in flight in parallel
 void UpdateShip(SpaceShip *ship);
+void UpdateShipPoints(SpaceShip *ship); // Transform the ship + jet triangles to its position
 void ResetShip(SpaceShip *ship);
 
 // Draw
 void DrawGameFrame(void); // Draws all the game's objects for the current frame
-void DrawAsteroid(Asteroid *rock);
-void DrawMissile(Missile *shot);
+Vector2 InterpolatePosition(Vector2 previous, Vector2 current); // Position between the last two ticks, across wraps
+void DrawAsteroids(void);
+void DrawMissiles(void);
 void DrawShip(SpaceShip *ship);
 
 // Game functions
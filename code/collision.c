@@ -0,0 +1,245 @@
+// EXPLANATION:
+// Collision for the wrapping game world
+// See collision.h for more documentation/descriptions
+
+#include "collision.h"
+
+#include <math.h> // for sqrtf
+
+#include "allocator.h"
+#include "config.h"
+#include "jobs.h"
+
+// What the build's job chunks work on
+typedef struct GridBuildJob {
+    CollisionGrid *grid;
+    const Vector2 *positions;
+} GridBuildJob;
+
+// Local Functions Declaration
+// ----------------------------------------------------------------------------
+void CountGridChunk(void *context, unsigned int chunk, unsigned int begin, unsigned int end); // Items per cell of one block
+void ScatterGridChunk(void *context, unsigned int chunk, unsigned int begin, unsigned int end); // One block's items to their cells
+
+Vector2 GetWrapOffset(Vector2 center, Vector2 target)
+{
+    Vector2 offset = { 0.0f, 0.0f };
+    float dx = target.x - center.x;
+    float dy = target.y - center.y;
+
+    if (dx > VIRTUAL_WIDTH/2.0f) offset.x = VIRTUAL_WIDTH;
+    else if (dx < -VIRTUAL_WIDTH/2.0f) offset.x = -VIRTUAL_WIDTH;
+    if (dy > VIRTUAL_HEIGHT/2.0f) offset.y = VIRTUAL_HEIGHT;
+    else if (dy < -VIRTUAL_HEIGHT/2.0f) offset.y = -VIRTUAL_HEIGHT;
+
+    return offset;
+}
+
+unsigned int GetWrapClones(Rectangle bounds, Vector2 offsets[WRAP_MAX_CLONES])
+{
+    // Past the left edge shows on the right, and so on. Objects are smaller
+    // than the screen, so they can't be past both edges of an axis
+    float dx = 0.0f;
+    float dy = 0.0f;
+    if (bounds.x < 0) dx = VIRTUAL_WIDTH;
+    else if (bounds.x + bounds.width > VIRTUAL_WIDTH) dx = -VIRTUAL_WIDTH;
+    if (bounds.y < 0) dy = VIRTUAL_HEIGHT;
+    else if (bounds.y + bounds.height > VIRTUAL_HEIGHT) dy = -VIRTUAL_HEIGHT;
+
+    unsigned int count = 0;
+    if (dx != 0.0f) offsets[count++] = (Vector2){ dx, 0.0f };
+    if (dy != 0.0f) offsets[count++] = (Vector2){ 0.0f, dy };
+    if (dx != 0.0f && dy != 0.0f) offsets[count++] = (Vector2){ dx, dy };
+
+    return count;
+}
+
+// The math below matches raylib's CheckCollisionCircles and CheckCollisionPointCircle
+// applied to the nearest clone, so results agree bit for bit
+bool CheckCollisionCirclesToroidal(Vector2 center1, float radius1, Vector2 center2, float radius2)
+{
+    Vector2 offset = GetWrapOffset(center1, center2);
+    float dx = center2.x - (center1.x + offset.x);
+    float dy = center2.y - (center1.y + offset.y);
+    float distanceSquared = dx*dx + dy*dy;
+    float radiusSum = radius1 + radius2;
+
+    return (distanceSquared <= radiusSum*radiusSum);
+}
+
+bool CheckCollisionPointCircleToroidal(Vector2 point, Vector2 center, float radius)
+{
+    Vector2 offset = GetWrapOffset(center, point);
+    float dx = point.x - (center.x + offset.x);
+    float dy = point.y - (center.y + offset.y);
+    float distanceSquared = dx*dx + dy*dy;
+
+    return (distanceSquared <= radius*radius);
+}
+
+bool CheckCollisionTriangleCircleToroidal(const Vector2 points[3], Vector2 center, float radius)
+{
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        if (CheckCollisionPointCircleToroidal(points[i], center, radius))
+            return true;
+    }
+
+    return false;
+}
+
+// Continuous version of the test above: the circles touch at some point of
+// the step if circle2's path, taken relative to circle1, comes within the
+// radius sum of it. Both move in straight lines during a step, so their
+// relative motion is a straight line too
+bool CheckCollisionSweptCirclesToroidal(Vector2 center1, float radius1, Vector2 center2, float radius2, Vector2 motion, float *time)
+{
+    // Where circle2 ended up and started from, relative to the nearest clone of circle1
+    Vector2 offset = GetWrapOffset(center1, center2);
+    float endX = center2.x - (center1.x + offset.x);
+    float endY = center2.y - (center1.y + offset.y);
+    float startX = endX - motion.x;
+    float startY = endY - motion.y;
+    float radiusSum = radius1 + radius2;
+
+    // Already touching when the step started
+    float c = startX*startX + startY*startY - radiusSum*radiusSum;
+    if (c <= 0)
+    {
+        *time = 0.0f;
+        return true;
+    }
+
+    // First contact is the smaller root of |start + motion*t|^2 = radiusSum^2
+    float a = motion.x*motion.x + motion.y*motion.y;
+    float b = startX*motion.x + startY*motion.y;
+    if (a <= 0 || b >= 0) return false; // not moving, or moving apart
+    float discriminant = b*b - a*c;
+    if (discriminant < 0) return false; // passes by
+
+    float t = (-b - sqrtf(discriminant))/a;
+    if (t > 1.0f) return false; // gets there after the step
+    *time = t;
+    return true;
+}
+
+void InitCollisionGrid(CollisionGrid *grid, unsigned int capacity, float cellSize)
+{
+    // Round the cell count down so every cell is at least cellSize
+    unsigned int columns = (unsigned int)(VIRTUAL_WIDTH/cellSize);
+    unsigned int rows = (unsigned int)(VIRTUAL_HEIGHT/cellSize);
+
+    // Fewer than 3 cells across would make the 3x3 block overlap itself
+    if (columns < 3) columns = 3;
+    if (rows < 3) rows = 3;
+
+    unsigned int chunkCount = (capacity + GRID_BUILD_CHUNK - 1)/GRID_BUILD_CHUNK;
+    if (chunkCount < 1) chunkCount = 1;
+
+    *grid = (CollisionGrid){ .columns = columns, .rows = rows, .capacity = capacity };
+    grid->cellStart = GameAlloc((columns*rows + 1)*sizeof(unsigned int));
+    grid->cellItems = GameAlloc(capacity*sizeof(unsigned int));
+    grid->itemCell = GameAlloc(capacity*sizeof(unsigned int));
+    grid->chunkCounts = GameAlloc(chunkCount*columns*rows*sizeof(unsigned int));
+}
+
+void FreeCollisionGrid(CollisionGrid *grid)
+{
+    GameFree(grid->cellStart);
+    GameFree(grid->cellItems);
+    GameFree(grid->itemCell);
+    GameFree(grid->chunkCounts);
+    *grid = (CollisionGrid){ 0 };
+}
+
+void BuildCollisionGrid(CollisionGrid *grid, const Vector2 *positions, unsigned int count)
+{
+    unsigned int cellCount = grid->columns*grid->rows;
+    if (count > grid->capacity) count = grid->capacity;
+    unsigned int chunkCount = (count + GRID_BUILD_CHUNK - 1)/GRID_BUILD_CHUNK;
+    GridBuildJob job = { grid, positions };
+
+    // Counting sort in blocks: every block counts its items per cell...
+    RunParallelFor(CountGridChunk, &job, count, GRID_BUILD_CHUNK);
+
+    // ...cell by cell, the counts turn into start offsets and each block's
+    // count into its write cursor, earlier blocks first...
+    unsigned int start = 0;
+    for (unsigned int c = 0; c < cellCount; c++)
+    {
+        grid->cellStart[c] = start;
+        for (unsigned int b = 0; b < chunkCount; b++)
+        {
+            unsigned int *cursor = &grid->chunkCounts[b*cellCount + c];
+            unsigned int items = *cursor;
+            *cursor = start;
+            start += items;
+        }
+    }
+    grid->cellStart[cellCount] = start;
+
+    // ...then every block scatters its items, so each cell lists them in index order
+    RunParallelFor(ScatterGridChunk, &job, count, GRID_BUILD_CHUNK);
+}
+
+void CountGridChunk(void *context, unsigned int chunk, unsigned int begin, unsigned int end)
+{
+    GridBuildJob *job = context;
+    CollisionGrid *grid = job->grid;
+    unsigned int cellCount = grid->columns*grid->rows;
+    unsigned int *counts = &grid->chunkCounts[chunk*cellCount];
+
+    for (unsigned int c = 0; c < cellCount; c++)
+        counts[c] = 0;
+    for (unsigned int i = begin; i < end; i++)
+    {
+        unsigned int cell = GetCollisionGridCell(grid, job->positions[i]);
+        grid->itemCell[i] = cell;
+        counts[cell]++;
+    }
+}
+
+void ScatterGridChunk(void *context, unsigned int chunk, unsigned int begin, unsigned int end)
+{
+    GridBuildJob *job = context;
+    CollisionGrid *grid = job->grid;
+    unsigned int *cursors = &grid->chunkCounts[chunk*grid->columns*grid->rows];
+
+    for (unsigned int i = begin; i < end; i++)
+        grid->cellItems[cursors[grid->itemCell[i]]++] = i;
+}
+
+unsigned int GetCollisionGridCell(CollisionGrid *grid, Vector2 position)
+{
+    int column = (int)(position.x*grid->columns/VIRTUAL_WIDTH);
+    int row = (int)(position.y*grid->rows/VIRTUAL_HEIGHT);
+
+    // Positions are wrapped into [0, size], clamp the far edges into the last cell
+    if (column < 0) column = 0;
+    if (column >= (int)grid->columns) column = grid->columns - 1;
+    if (row < 0) row = 0;
+    if (row >= (int)grid->rows) row = grid->rows - 1;
+
+    return row*grid->columns + column;
+}
+
+void GetCollisionGridNeighbors(CollisionGrid *grid, Vector2 position, unsigned int cells[GRID_NEIGHBORS])
+{
+    unsigned int cell = GetCollisionGridCell(grid, position);
+    unsigned int column = cell%grid->columns;
+    unsigned int row = cell/grid->columns;
+
+    // Wrap around the screen edges
+    unsigned int left = (column + grid->columns - 1)%grid->columns;
+    unsigned int right = (column + 1)%grid->columns;
+    unsigned int up = (row + grid->rows - 1)%grid->rows;
+    unsigned int down = (row + 1)%grid->rows;
+
+    unsigned int columns[3] = { left, column, right };
+    unsigned int rows[3] = { up, row, down };
+    for (unsigned int y = 0; y < 3; y++)
+    {
+        for (unsigned int x = 0; x < 3; x++)
+            cells[y*3 + x] = rows[y]*grid->columns + columns[x];
+    }
+}
@@ -0,0 +1,61 @@
+// EXPLANATION:
+// Collision for the wrapping game world
+// - Toroidal tests measure the shortest way around the screen edges, so an
+//   object at the edge costs the same as one in the middle (no clone tests)
+// - Objects are bucketed into a uniform grid once per frame, so a query only
+//   looks at the 3x3 block of cells around a point instead of every object.
+//   The grid wraps at the screen edges like the objects themselves do.
+// - The grid is built in blocks of GRID_BUILD_CHUNK items on the job system
+//   (see jobs.h), and comes out the same as a serial build: each cell lists
+//   its items in index order
+
+#ifndef ASTEROIDS_COLLISION_HEADER_GUARD
+#define ASTEROIDS_COLLISION_HEADER_GUARD
+
+#include "raylib.h"
+
+// Macros
+// ----------------------------------------------------------------------------
+#define GRID_NEIGHBORS 9 // cells in the 3x3 block around a query point
+#define WRAP_MAX_CLONES 3 // an object over a corner shows on the two sides and the opposite corner
+#define GRID_BUILD_CHUNK 4096 // items bucketed per job chunk
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+
+// Cells are at least cellSize wide and tall, so anything within cellSize of a
+// query point is found in its 3x3 block
+typedef struct CollisionGrid {
+    unsigned int *cellStart; // items of cell c are cellItems[cellStart[c]] up to cellStart[c + 1]
+    unsigned int *cellItems; // item indices sorted by cell
+    unsigned int *itemCell;  // cell of each item, scratch for the rebuild
+    unsigned int *chunkCounts; // items per cell of each GRID_BUILD_CHUNK block, then its write cursors, scratch for the rebuild
+    unsigned int columns;
+    unsigned int rows;
+    unsigned int capacity;
+} CollisionGrid;
+
+// Prototypes
+// ----------------------------------------------------------------------------
+
+// Toroidal tests
+// They give the same result as testing every wrapped clone of `center`,
+// as long as the objects are smaller than half the screen
+Vector2 GetWrapOffset(Vector2 center, Vector2 target); // Offset that moves center to its clone nearest target
+unsigned int GetWrapClones(Rectangle bounds, Vector2 offsets[WRAP_MAX_CLONES]); // Offsets of the clones that show on screen
+                                                                                 // for an object with these bounds, returns how many
+bool CheckCollisionCirclesToroidal(Vector2 center1, float radius1, Vector2 center2, float radius2);
+bool CheckCollisionPointCircleToroidal(Vector2 point, Vector2 center, float radius);
+bool CheckCollisionTriangleCircleToroidal(const Vector2 points[3], Vector2 center, float radius); // Any vertex inside the circle
+bool CheckCollisionSweptCirclesToroidal(Vector2 center1, float radius1, Vector2 center2, float radius2,
+                                        Vector2 motion, float *time); // circle2 ended at center2 after moving by motion relative to circle1,
+                                                                      // time is how far along (0 to 1) they first touched
+
+// Uniform grid
+void InitCollisionGrid(CollisionGrid *grid, unsigned int capacity, float cellSize); // Allocates for capacity items
+void FreeCollisionGrid(CollisionGrid *grid);
+void BuildCollisionGrid(CollisionGrid *grid, const Vector2 *positions, unsigned int count); // Bucket items by position
+unsigned int GetCollisionGridCell(CollisionGrid *grid, Vector2 position);
+void GetCollisionGridNeighbors(CollisionGrid *grid, Vector2 position, unsigned int cells[GRID_NEIGHBORS]);
+
+#endif // ASTEROIDS_COLLISION_HEADER_GUARD
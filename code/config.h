@@ -16,8 +16,48 @@
 #define DEFAULT_HEIGHT 720 // Default size of the game window
 #define DEFAULT_WIDTH (int)(DEFAULT_HEIGHT*ASPECT_RATIO)
 
-// there may be small bugs with very high FPS (uncapped + no vsync), but should work fine overall
 #define MAX_FRAMERATE 120 // Set to 0 for uncapped framerate
 #define VSYNC_ENABLED true
 
+// The game simulation steps at a fixed rate, independent of the framerate above
+// Drawing interpolates between the last two steps. Can be lowered for weak
+// devices (e.g. -DSIM_TICK_RATE=30), missiles are swept so they still hit
+#if !defined(SIM_TICK_RATE)
+    #define SIM_TICK_RATE 120 // simulation steps per second
+#endif
+#define SIM_TICK_TIME (1.0f/SIM_TICK_RATE)
+#define SIM_MAX_FRAME_TIME 0.25f // longest frame the simulation catches up on, slower frames run in slow motion
+
+// Profiler zones and overlay (F3), left out of release builds
+#if !defined(NDEBUG)
+    #define PROFILER_ENABLED
+#endif
+
+// Chrome trace export of the profiler zones (--trace), desktop only since it
+// writes from a background thread. Kept in release builds so traces can be
+// captured from the shipped game, the zones then cost a branch each while
+// not tracing. Define TRACE_DISABLED to take it out completely
+#if defined(PLATFORM_DESKTOP) && !defined(TRACE_DISABLED)
+    #define TRACE_ENABLED
+#endif
+
+// Input latency measurement (--latency), desktop only since the web build
+// has no command line. Define LATENCY_DISABLED to take it out completely
+#if defined(PLATFORM_DESKTOP) && !defined(LATENCY_DISABLED)
+    #define LATENCY_ENABLED
+#endif
+
+// Worker threads for the simulation's parallel phases (see jobs.h), not on
+// the web since it's built without pthreads. Define JOBS_DISABLED to run
+// every phase on the game thread
+#if !defined(PLATFORM_WEB) && !defined(JOBS_DISABLED)
+    #define JOBS_ENABLED
+#endif
+
+// SIMD batch kernels (see kernels.h), for whichever instruction set the
+// compiler targets. Define SIMD_DISABLED to run their scalar loops instead
+#if !defined(SIMD_DISABLED)
+    #define SIMD_ENABLED
+#endif
+
 #endif // ASTEROIDS_CONFIG_HEADER_GUARD
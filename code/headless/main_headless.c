@@ -0,0 +1,126 @@
+// EXPLANATION:
+// Entry point for the headless build
+// Steps the game simulation as fast as possible with a scripted pilot,
+// no window, GL or audio device needed (e.g. for build servers)
+//
+// Usage: asteroids_headless [--ticks N] [--seed N] [--threads N] [--fail-on-alloc] [--record FILE] [--replay FILE]
+// --threads sets how many threads run the simulation's parallel phases, 0 (default) for one per core
+// --fail-on-alloc exits with an error if a game tick allocates memory
+// --record saves the scripted session, --replay runs a recorded one instead
+// (its seed and tick count replace --seed and --ticks)
+
+#include "../asteroids.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../allocator.h"
+#include "../config.h"
+#include "../input.h"
+#include "../jobs.h"
+#include "../replay.h"
+
+#define DEFAULT_TICKS 1000000
+
+// Globals
+// ----------------------------------------------------------------------------
+GameState game; // game data
+
+// Local Functions Declaration
+// ----------------------------------------------------------------------------
+void UpdateScriptedInput(TickInput *input, unsigned long long tick); // Fly in circles and keep shooting
+
+int main(int argc, char **argv)
+{
+    unsigned long long tickCount = DEFAULT_TICKS;
+    unsigned int seed = 1;
+    unsigned int threadCount = 0;
+    bool failOnAlloc = false;
+    const char *recordPath = 0;
+    const char *replayPath = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)
+            tickCount = strtoull(argv[++i], 0, 10);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            seed = (unsigned int)strtoul(argv[++i], 0, 10);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threadCount = (unsigned int)strtoul(argv[++i], 0, 10);
+        else if (strcmp(argv[i], "--fail-on-alloc") == 0)
+            failOnAlloc = true;
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            replayPath = argv[++i];
+        else
+        {
+            fprintf(stderr, "Usage: %s [--ticks N] [--seed N] [--threads N] [--fail-on-alloc] [--record FILE] [--replay FILE]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (replayPath)
+    {
+        if (!LoadReplay(replayPath)) return 1;
+        seed = replay.seed;
+        tickCount = replay.tickCount;
+    }
+    else if (recordPath)
+        StartRecording(seed, (unsigned int)tickCount);
+
+    InitJobSystem(threadCount);
+    InitGameState(seed);
+    game.currentScreen = SCREEN_GAMEPLAY;
+
+    double startTime = GetTime();
+    for (unsigned long long tick = 0; tick < tickCount; tick++)
+    {
+        if (replay.mode == REPLAY_PLAYING)
+            PlayReplayTick(&game.input);
+        else
+        {
+            UpdateScriptedInput(&game.input, tick);
+            RecordReplayTick(&game.input);
+        }
+        unsigned long long allocationsBefore = allocator.count;
+        UpdateGameTick();
+        ConsumeTickInput(&game.input);
+
+        // Everything the game needs is allocated up front by InitGameState
+        if (failOnAlloc && allocator.count != allocationsBefore)
+        {
+            fprintf(stderr, "FAIL: tick %llu allocated memory\n", tick);
+            LogAllocSites(LOG_ERROR);
+            return 1;
+        }
+    }
+    double elapsed = GetTime() - startTime;
+
+    printf("ticks:            %llu (%.1f s of game time)\n", tickCount, tickCount*(double)SIM_TICK_TIME);
+    printf("wall time:        %.3f s on %u threads\n", elapsed, jobs.threadCount);
+    printf("ticks per second: %.0f\n", (elapsed > 0)? tickCount/elapsed : 0.0);
+    printf("rocks destroyed:  %u\n", game.eliminatedCount);
+    printf("rock pool:        peak %u/%u live, %u slots reused\n",
+           game.rocks.peakCount, game.rocks.capacity, game.rocks.reuseCount);
+    printf("heap:             %llu allocations, %llu bytes peak\n", allocator.count, allocator.peakBytes);
+
+    if (recordPath && !replayPath && !SaveReplay(recordPath)) return 1;
+    FreeReplay();
+    FreeGameState();
+    FreeJobSystem();
+
+    return 0;
+}
+
+void UpdateScriptedInput(TickInput *input, unsigned long long tick)
+{
+    unsigned long long second = tick/SIM_TICK_RATE;
+
+    input->actionsDown = INPUT_ACTION_BIT(INPUT_ACTION_RIGHT);
+    if (second%2 == 0)
+        input->actionsDown |= INPUT_ACTION_BIT(INPUT_ACTION_FORWARD);
+    if (tick%((SIM_TICK_RATE >= 8)? SIM_TICK_RATE/8 : 1) == 0) // 8 shots a second, or every tick below that rate
+        input->actionsPressed |= INPUT_ACTION_BIT(INPUT_ACTION_SHOOT);
+}
@@ -0,0 +1,118 @@
+// EXPLANATION:
+// Platform layer for the headless build (no window, GL or audio device)
+// - Stubs the game's audio services from platform.h
+// - Stands in for the few raylib core utilities the simulation calls,
+//   so the simulation links without raylib at all
+// See platform.h for more documentation/descriptions
+
+#define _POSIX_C_SOURCE 199309L // for clock_gettime
+
+#include "../platform.h"
+
+#include <stdarg.h> // for TraceLog's variable arguments
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// raymath.h only declares its functions inline, emit the definitions here
+// since there's no raylib library to provide them
+#define RAYMATH_IMPLEMENTATION
+#include "raymath.h"
+
+#define ARRAY_SIZE(arr) (sizeof(arr)/sizeof((arr)[0]))
+
+// Globals
+// ----------------------------------------------------------------------------
+int traceLogLevel = LOG_INFO;
+
+#if defined(_WIN32)
+// Declared by hand, windows.h clashes with raylib.h
+__declspec(dllimport) int __stdcall QueryPerformanceCounter(long long *count);
+__declspec(dllimport) int __stdcall QueryPerformanceFrequency(long long *frequency);
+#endif
+
+// Audio
+// ----------------------------------------------------------------------------
+void InitGameAudio(void) { }
+void FreeGameAudio(void) { }
+void PlayGameBeep(GameBeep beep) { (void)beep; }
+
+// raylib stand-ins
+// ----------------------------------------------------------------------------
+void *MemAlloc(unsigned int size)
+{
+    return calloc(size, 1);
+}
+
+void *MemRealloc(void *ptr, unsigned int size)
+{
+    return realloc(ptr, size);
+}
+
+void MemFree(void *ptr)
+{
+    free(ptr);
+}
+
+void SetTraceLogLevel(int logLevel)
+{
+    traceLogLevel = logLevel;
+}
+
+void TraceLog(int logLevel, const char *text, ...)
+{
+    if (logLevel < traceLogLevel) return;
+
+    static const char *levels[] = { "ALL", "TRACE", "DEBUG", "INFO", "WARNING", "ERROR", "FATAL", "NONE" };
+    if (logLevel >= 0 && (unsigned int)logLevel < ARRAY_SIZE(levels))
+        fprintf(stderr, "%s: ", levels[logLevel]);
+    else
+        fprintf(stderr, "LOG %d: ", logLevel); // not one of raylib's levels
+
+    va_list args;
+    va_start(args, text);
+    vfprintf(stderr, text, args);
+    va_end(args);
+    fprintf(stderr, "\n");
+}
+
+double GetTime(void)
+{
+#if defined(_WIN32)
+    long long count, frequency;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&frequency);
+    return (double)count/frequency;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec*1e-9;
+#endif
+}
+
+// Same math as raylib, only used for the rock color variations
+Color ColorBrightness(Color color, float factor)
+{
+    if (factor > 1.0f) factor = 1.0f;
+    else if (factor < -1.0f) factor = -1.0f;
+
+    float red = (float)color.r;
+    float green = (float)color.g;
+    float blue = (float)color.b;
+
+    if (factor < 0.0f)
+    {
+        factor = 1.0f + factor;
+        red *= factor;
+        green *= factor;
+        blue *= factor;
+    }
+    else
+    {
+        red = (255 - red)*factor + red;
+        green = (255 - green)*factor + green;
+        blue = (255 - blue)*factor + blue;
+    }
+
+    return (Color){ (unsigned char)red, (unsigned char)green, (unsigned char)blue, color.a };
+}
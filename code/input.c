@@ -5,8 +5,19 @@
 #include "raymath.h"
 #include "config.h"
 
+#if !defined(PLATFORM_HEADLESS) // headless builds have no devices, their input is scripted
 // Global struct to track input key mappings
 InputMappings gameInput = { 0 };
+CompiledInput compiledInput = { 0 }; // gameInput as of the last CompileInputMappings()
+InputActionState inputActions = { 0 }; // this frame's actions
+InputSampler inputSampler = { 0 }; // device state as of the last sample
+InputEventQueue inputEvents = { 0 }; // transitions not yet fed to a tick
+double inputPressTimes[INPUT_ACTIONS_COUNT] = { 0 }; // of the last press each action fed to a tick
+
+// Local Functions Declaration
+// ----------------------------------------------------------------------------
+unsigned int EvaluateInputBindings(void); // INPUT_ACTION_BIT of every action held right now
+bool PushInputEvent(InputEvent event); // false if the queue is full
 
 void InitDefaultInputControls(void)
 {
@@ -26,6 +37,7 @@ void InitDefaultInputControls(void)
         .keyMaps[INPUT_ACTION_MENU_UP] =   { KEY_W, KEY_UP },
         .keyMaps[INPUT_ACTION_MENU_DOWN] = { KEY_S, KEY_UP },
         .keyMaps[INPUT_ACTION_PAUSE] =     { KEY_P },
+        .keyMaps[INPUT_ACTION_PROFILER] =  { KEY_F3 },
 
         // Player 1 controls
         .keyMaps[INPUT_ACTION_LEFT] =      { KEY_A, KEY_LEFT, },
@@ -34,9 +46,11 @@ void InitDefaultInputControls(void)
         .mouseMaps[INPUT_ACTION_FORWARD] = { INPUT_MOUSE_LEFT_BUTTON },
         .keyMaps[INPUT_ACTION_SHOOT] =     { KEY_SPACE },
         .mouseMaps[INPUT_ACTION_SHOOT] =   { MOUSE_RIGHT_BUTTON },
+        .keyMaps[INPUT_ACTION_REWIND] =    { KEY_R },
     };
 
     gameInput = defaultControls;
+    CompileInputMappings();
 }
 
 bool IsInputKeyModifier(KeyboardKey key)
@@ -48,90 +62,241 @@ bool IsInputKeyModifier(KeyboardKey key)
     return false;
 }
 
-bool IsInputActionPressed(InputAction action)
+void CompileInputMappings(void)
 {
-    KeyboardKey* keys = gameInput.keyMaps[action];
+    compiledInput = (CompiledInput){ 0 };
 
-    // Check potential key combinations
-    for (unsigned int i = 0; i < INPUT_MAX_MAPS && keys[i] != 0; i++)
+    for (unsigned int action = 0; action < INPUT_ACTIONS_COUNT; action++)
     {
-        KeyboardKey key = keys[i];
+        InputBinding *bindings = compiledInput.bindings[action];
+        unsigned int count = 0;
 
-        // Check modifier plus next key (only 1 modifier for now)
-        if (IsInputKeyModifier(key))
+        KeyboardKey *keys = gameInput.keyMaps[action];
+        for (unsigned int i = 0; i < INPUT_MAX_MAPS && keys[i] != 0; i++)
         {
-            if ((i + 1 < INPUT_MAX_MAPS) && (keys[i + 1] != 0) &&
-                (!IsInputKeyModifier(keys[i + 1])))
+            KeyboardKey key = keys[i];
+
+            // Modifier plus next key (only 1 modifier for now)
+            if (IsInputKeyModifier(key) && (i + 1 < INPUT_MAX_MAPS) &&
+                (keys[i + 1] != 0) && (!IsInputKeyModifier(keys[i + 1])))
             {
-                if (IsKeyDown(key) && IsKeyPressed(keys[i + 1]))
-                    return true;
+                bindings[count++] = (InputBinding){ .modifier = key, .button = keys[i + 1] };
                 i++; // Skip the next key
             }
-            // Check just the modifier by itself
-            else if (IsKeyPressed(key))
-                return true;
+
+            // A single key, or just the modifier by itself
+            else
+                bindings[count++] = (InputBinding){ .button = key };
         }
 
-        // Check a single key
-        else if (IsKeyPressed(key))
-            return true;
+        MouseButton *mb = gameInput.mouseMaps[action];
+        for (unsigned int i = 0; i < INPUT_MAX_MAPS && mb[i] != 0; i++)
+        {
+            MouseButton button = mb[i];
+            if (button == INPUT_MOUSE_LEFT_BUTTON)
+                button = MOUSE_LEFT_BUTTON;
+            bindings[count++] = (InputBinding){ .button = button, .isMouse = true };
+        }
+
+        compiledInput.bindingCount[action] = (unsigned char)count;
     }
+}
 
-    // Check mouse buttons
-    MouseButton* mb = gameInput.mouseMaps[action];
-    for (unsigned int i = 0; i < INPUT_MAX_MAPS && mb[i] != 0; i++)
+unsigned int EvaluateInputBindings(void)
+{
+    unsigned int down = 0;
+
+    for (unsigned int action = 0; action < INPUT_ACTIONS_COUNT; action++)
     {
-        MouseButton button = mb[i];
-        if (button == 0) button = INPUT_MOUSE_NULL;
-        if (button == INPUT_MOUSE_LEFT_BUTTON)
-            button = MOUSE_LEFT_BUTTON;
-        if (IsMouseButtonPressed(button))
-            return true;
+        InputBinding *bindings = compiledInput.bindings[action];
+        for (unsigned int i = 0; i < compiledInput.bindingCount[action]; i++)
+        {
+            InputBinding binding = bindings[i];
+            bool isDown;
+            if (binding.isMouse)
+                isDown = IsMouseButtonDown(binding.button);
+            else
+                isDown = ((binding.modifier == KEY_NULL) || IsKeyDown(binding.modifier)) && IsKeyDown(binding.button);
+
+            if (isDown)
+            {
+                down |= INPUT_ACTION_BIT(action);
+                break;
+            }
+        }
     }
 
-    return false;
+    return down;
 }
 
-bool IsInputActionDown(InputAction action)
+bool PushInputEvent(InputEvent event)
+{
+    if (inputEvents.count == INPUT_EVENT_QUEUE_SIZE)
+    {
+        inputEvents.droppedCount++;
+        return false;
+    }
+
+    unsigned int tail = (inputEvents.head + inputEvents.count)%INPUT_EVENT_QUEUE_SIZE;
+    inputEvents.events[tail] = event;
+    inputEvents.count++;
+    return true;
+}
+
+void SampleInputEvents(void)
 {
-    KeyboardKey* keys = gameInput.keyMaps[action];
+    double now = GetTime();
+
+    // Actions, a transition only counts once its event is queued so a
+    // full queue retries it on the next sample instead of losing a release
+    unsigned int down = EvaluateInputBindings();
+    unsigned int changed = down ^ inputSampler.actionsDown;
+    for (unsigned int action = 0; changed != 0; action++, changed >>= 1)
+    {
+        if (!(changed & 1)) continue;
+
+        bool isDown = (down & INPUT_ACTION_BIT(action)) != 0;
+        InputEvent event = { .time = now, .type = isDown? INPUT_EVENT_ACTION_DOWN : INPUT_EVENT_ACTION_UP, .code = action };
+        if (!PushInputEvent(event)) continue;
+
+        inputSampler.actionsDown ^= INPUT_ACTION_BIT(action);
+        if (isDown) inputSampler.actionsPressed |= INPUT_ACTION_BIT(action);
+        else inputSampler.actionsReleased |= INPUT_ACTION_BIT(action);
+    }
 
-    for (unsigned int i = 0; i < INPUT_MAX_MAPS && keys[i] != 0; i++)
+    // Mouse buttons the simulation looks at directly
+    MouseButton buttons[] = { MOUSE_LEFT_BUTTON, MOUSE_RIGHT_BUTTON };
+    for (unsigned int i = 0; i < sizeof(buttons)/sizeof(buttons[0]); i++)
     {
-        KeyboardKey key = keys[i];
+        unsigned int bit = 1u << buttons[i];
+        bool isDown = IsMouseButtonDown(buttons[i]);
+        if (isDown == ((inputSampler.mouseButtonsDown & bit) != 0)) continue;
 
-        // Check modifier plus next key (only 1 modifier for now)
-        if (IsInputKeyModifier(key))
+        InputEvent event = { .time = now, .type = isDown? INPUT_EVENT_MOUSE_DOWN : INPUT_EVENT_MOUSE_UP, .code = buttons[i] };
+        if (!PushInputEvent(event)) continue;
+
+        inputSampler.mouseButtonsDown ^= bit;
+        if (isDown) inputSampler.mouseButtonsPressed |= bit;
+    }
+
+    // Mouse movement, in screen pixels so a resize alone isn't a move
+    Vector2 mouse = GetMousePosition();
+    if (!Vector2Equals(mouse, inputSampler.mouseScreenPosition))
+    {
+        InputEvent event = { .time = now, .type = INPUT_EVENT_MOUSE_MOVE, .mousePosition = GetScaledMousePosition() };
+        if (PushInputEvent(event))
         {
-            if ((i + 1 < INPUT_MAX_MAPS) && (keys[i + 1] != 0) &&
-                (!IsInputKeyModifier(keys[i + 1])))
-            {
-                if (IsKeyDown(key) && IsKeyDown(keys[i + 1]))
-                    return true;
-                i++;
-            }
-            // Check just the modifier by itself
-            else if (IsKeyDown(key))
-                return true;
+            inputSampler.mouseDelta = Vector2Add(inputSampler.mouseDelta, Vector2Subtract(mouse, inputSampler.mouseScreenPosition));
+            inputSampler.mouseScreenPosition = mouse;
         }
+    }
 
-        else if (IsKeyDown(key))
-            return true;
+    // For "press any key", whether it's mapped or not
+    while (GetKeyPressed() != 0)
+        inputSampler.anyKeyPressed = true;
+}
+
+void WaitAndSampleInput(double untilTime)
+{
+    double remaining = untilTime - GetTime();
+    while (remaining > 0.0)
+    {
+        WaitTime((remaining < INPUT_POLL_INTERVAL)? remaining : INPUT_POLL_INTERVAL);
+        PollInputEvents();
+        SampleInputEvents();
+        remaining = untilTime - GetTime();
     }
+}
+
+void UpdateInputActions(void)
+{
+    SampleInputEvents(); // what EndDrawing() polled
+
+    inputActions.down = inputSampler.actionsDown;
+    inputActions.pressed = inputSampler.actionsPressed;
+    inputActions.released = inputSampler.actionsReleased;
+    inputActions.mouseButtonsPressed = inputSampler.mouseButtonsPressed;
+    inputActions.mouseDelta = inputSampler.mouseDelta;
+    inputActions.anyKeyPressed = inputSampler.anyKeyPressed;
 
-    // Check mouse buttons
-    MouseButton* mb = gameInput.mouseMaps[action];
-    for (unsigned int i = 0; i < INPUT_MAX_MAPS && mb[i] != 0; i++)
+    // Start gathering the next frame's
+    inputSampler.actionsPressed = 0;
+    inputSampler.actionsReleased = 0;
+    inputSampler.mouseButtonsPressed = 0;
+    inputSampler.mouseDelta = (Vector2){ 0 };
+    inputSampler.anyKeyPressed = false;
+}
+
+void ApplyInputEvents(TickInput *input, double untilTime)
+{
+    while (inputEvents.count > 0)
     {
-        MouseButton button = mb[i];
-        if (button == 0) button = INPUT_MOUSE_NULL;
-        if (button == INPUT_MOUSE_LEFT_BUTTON)
-            button = MOUSE_LEFT_BUTTON;
-        if (IsMouseButtonDown(button))
-            return true;
+        InputEvent *event = &inputEvents.events[inputEvents.head];
+        if (event->time > untilTime) break;
+
+        switch (event->type)
+        {
+            case INPUT_EVENT_ACTION_DOWN:  input->actionsDown |= INPUT_ACTION_BIT(event->code);
+                                           input->actionsPressed |= INPUT_ACTION_BIT(event->code);
+                                           inputPressTimes[event->code] = event->time;
+                                           break;
+            case INPUT_EVENT_ACTION_UP:    input->actionsDown &= ~INPUT_ACTION_BIT(event->code);
+                                           break;
+            case INPUT_EVENT_MOUSE_DOWN:
+            case INPUT_EVENT_MOUSE_UP:     if (event->code == MOUSE_LEFT_BUTTON)
+                                               input->mouseLeftDown = (event->type == INPUT_EVENT_MOUSE_DOWN);
+                                           else
+                                               input->mouseRightDown = (event->type == INPUT_EVENT_MOUSE_DOWN);
+                                           break;
+            case INPUT_EVENT_MOUSE_MOVE:   input->mousePosition = event->mousePosition;
+                                           input->mouseMoved = true;
+                                           break;
+            default: break;
+        }
+
+        inputEvents.head = (inputEvents.head + 1)%INPUT_EVENT_QUEUE_SIZE;
+        inputEvents.count--;
     }
+}
 
-    return false;
+bool IsInputActionPressed(InputAction action)
+{
+    return (inputActions.pressed & INPUT_ACTION_BIT(action)) != 0;
+}
+
+bool IsInputActionDown(InputAction action)
+{
+    return (inputActions.down & INPUT_ACTION_BIT(action)) != 0;
+}
+
+bool IsInputActionReleased(InputAction action)
+{
+    return (inputActions.released & INPUT_ACTION_BIT(action)) != 0;
+}
+
+bool IsInputMouseButtonPressed(MouseButton button)
+{
+    return (inputActions.mouseButtonsPressed & (1u << button)) != 0;
+}
+
+bool IsInputAnyKeyPressed(void)
+{
+    return inputActions.anyKeyPressed;
+}
+
+bool IsInputTapped(void)
+{
+    return IsInputMouseButtonPressed(MOUSE_LEFT_BUTTON) || IsGestureDetected(GESTURE_TAP);
+}
+
+Vector2 GetInputMouseDelta(void)
+{
+    return inputActions.mouseDelta;
+}
+
+double GetInputPressTime(InputAction action)
+{
+    return inputPressTimes[action];
 }
 
 #define MIN(a, b) ((a)<(b)? (a) : (b))
@@ -158,7 +323,24 @@ void HandleToggleFullscreen(void)
     {
         // Borderless Windowed is generally nicer to use on desktop
         ToggleBorderlessWindowed();
-        PollInputEvents(); // Skip to the next frame's input
+        inputActions.pressed = 0; // Skip the rest of this frame's presses
     }
 #endif
 }
+#endif
+
+void ConsumeTickInput(TickInput *input)
+{
+    input->actionsPressed = 0;
+    input->mouseMoved = false;
+}
+
+bool IsTickActionDown(const TickInput *input, InputAction action)
+{
+    return (input->actionsDown & INPUT_ACTION_BIT(action)) != 0;
+}
+
+bool IsTickActionPressed(const TickInput *input, InputAction action)
+{
+    return (input->actionsPressed & INPUT_ACTION_BIT(action)) != 0;
+}
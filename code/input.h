@@ -15,6 +15,11 @@
 #define INPUT_MOUSE_NULL 7
 #define INPUT_MOUSE_LEFT_BUTTON 8
 
+#define INPUT_ACTION_BIT(action) (1u << (action))
+
+#define INPUT_EVENT_QUEUE_SIZE 1024 // transitions waiting for their tick
+#define INPUT_POLL_INTERVAL 0.001   // seconds between device polls while waiting for the next frame
+
 // Types and Structures
 // ----------------------------------------------------------------------------
 typedef enum InputAction {
@@ -24,11 +29,13 @@ typedef enum InputAction {
     INPUT_ACTION_MENU_UP,
     INPUT_ACTION_MENU_DOWN,
     INPUT_ACTION_PAUSE,
+    INPUT_ACTION_PROFILER,
 
     INPUT_ACTION_LEFT,
     INPUT_ACTION_RIGHT,
     INPUT_ACTION_FORWARD,
     INPUT_ACTION_SHOOT,
+    INPUT_ACTION_REWIND,
 } InputAction;
 
 typedef struct InputMappings {
@@ -36,13 +43,102 @@ typedef struct InputMappings {
     MouseButton mouseMaps[INPUT_ACTIONS_COUNT][INPUT_MAX_MAPS];
 } InputMappings;
 
+// One way to trigger an action, with the modifier pairs already worked out
+typedef struct InputBinding {
+    int modifier; // KeyboardKey held along with the key, KEY_NULL for none
+    int button;   // KeyboardKey, or MouseButton if isMouse
+    bool isMouse;
+} InputBinding;
+
+// InputMappings flattened into a list of bindings per action
+// Rebuilt by CompileInputMappings() whenever the mappings change
+typedef struct CompiledInput {
+    InputBinding bindings[INPUT_ACTIONS_COUNT][INPUT_MAX_MAPS*2]; // keys then mouse buttons
+    unsigned char bindingCount[INPUT_ACTIONS_COUNT];
+} CompiledInput;
+
+// State of every action this frame, gathered from the samples since the last
+// frame by UpdateInputActions()
+typedef struct InputActionState {
+    unsigned int down;     // INPUT_ACTION_BIT of each held action
+    unsigned int pressed;  // actions that went down since the last frame
+    unsigned int released; // actions that went up since the last frame
+    unsigned int mouseButtonsPressed; // bit per MouseButton
+    Vector2 mouseDelta;    // in screen pixels
+    bool anyKeyPressed;    // mapped or not
+} InputActionState;
+
+// Device state as of the last SampleInputEvents(), and what has changed
+// since the last frame
+typedef struct InputSampler {
+    unsigned int actionsDown;
+    unsigned int actionsPressed;
+    unsigned int actionsReleased;
+    unsigned int mouseButtonsDown;
+    unsigned int mouseButtonsPressed;
+    Vector2 mouseScreenPosition;
+    Vector2 mouseDelta;
+    bool anyKeyPressed;
+} InputSampler;
+
+typedef enum InputEventType {
+    INPUT_EVENT_ACTION_DOWN,
+    INPUT_EVENT_ACTION_UP,
+    INPUT_EVENT_MOUSE_DOWN,
+    INPUT_EVENT_MOUSE_UP,
+    INPUT_EVENT_MOUSE_MOVE,
+} InputEventType;
+
+// One input transition, timestamped when it was sampled
+typedef struct InputEvent {
+    double time;           // GetTime() of the sample that saw it
+    InputEventType type;
+    unsigned int code;     // InputAction, or MouseButton for mouse button events
+    Vector2 mousePosition; // scaled to the game world, for INPUT_EVENT_MOUSE_MOVE
+} InputEvent;
+
+// Ring buffer of transitions, the simulation takes them in order, each in
+// the tick it happened in
+typedef struct InputEventQueue {
+    InputEvent events[INPUT_EVENT_QUEUE_SIZE];
+    unsigned int head;
+    unsigned int count;
+    unsigned long long droppedCount; // retried on the next sample
+} InputEventQueue;
+
+// Input for one simulation tick
+// Built from the input events up to the tick's end, presses are kept until
+// a tick consumes them
+typedef struct TickInput {
+    unsigned int actionsDown;    // INPUT_ACTION_BIT of each held action
+    unsigned int actionsPressed; // actions pressed since the last tick
+    Vector2 mousePosition;       // scaled to the game world
+    bool mouseMoved;             // since the last tick
+    bool mouseLeftDown;
+    bool mouseRightDown;
+} TickInput;
+
 // Prototypes
 // ----------------------------------------------------------------------------
 void InitDefaultInputControls(void); // Sets the default key mapping control scheme
+void CompileInputMappings(void); // Call after changing gameInput's key/mouse maps
+void SampleInputEvents(void); // Queue the transitions since the last sample, after every PollInputEvents()
+void WaitAndSampleInput(double untilTime); // Wait out the frame while polling input every INPUT_POLL_INTERVAL
+void UpdateInputActions(void); // Gather this frame's action bitsets, at the start of the frame
+void ApplyInputEvents(TickInput *input, double untilTime); // Feed the queued events up to a tick's end time
 bool IsInputKeyModifier(KeyboardKey key);
 bool IsInputActionPressed(InputAction action);
 bool IsInputActionDown(InputAction action);
+bool IsInputActionReleased(InputAction action);
+bool IsInputMouseButtonPressed(MouseButton button); // Since the last frame, unlike raylib's since the last poll
+bool IsInputAnyKeyPressed(void);
+bool IsInputTapped(void); // Left click or touch tap
+Vector2 GetInputMouseDelta(void); // Since the last frame, in screen pixels
+double GetInputPressTime(InputAction action); // When the last press fed to a tick was sampled
 Vector2 GetScaledMousePosition(void);
+void ConsumeTickInput(TickInput *input); // Clear the presses once a tick has seen them
+bool IsTickActionDown(const TickInput *input, InputAction action);
+bool IsTickActionPressed(const TickInput *input, InputAction action);
 void HandleToggleFullscreen(void);
 
 #endif // ASTEROIDS_INPUT_HEADER_GUARD
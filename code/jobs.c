@@ -0,0 +1,396 @@
+// EXPLANATION:
+// Small work-stealing job system
+// See jobs.h for more documentation/descriptions
+
+#include "jobs.h"
+
+#include "config.h"
+
+#if defined(JOBS_ENABLED)
+    #if defined(_WIN32)
+        #define WIN32_LEAN_AND_MEAN
+        #include <windows.h>
+    #else
+        #include <pthread.h>
+        #include <unistd.h> // for sysconf
+    #endif
+#endif
+
+// Globals
+// ----------------------------------------------------------------------------
+JobSystem jobs = { .threadCount = 1 };
+
+// Local Functions Declaration
+// ----------------------------------------------------------------------------
+void RunChunksInOrder(JobFunction function, void *context, unsigned int itemCount, unsigned int chunkSize);
+
+#if defined(JOBS_ENABLED)
+
+// The chunks [begin, end) a thread has left, begin in the low half. The owner
+// takes from the front and thieves take from the back, both with a
+// compare-exchange of the whole range
+typedef struct JobShare {
+    volatile unsigned long long range;
+    char padding[64 - sizeof(unsigned long long)]; // a cache line each, they're hammered from every thread
+} JobShare;
+
+JobShare jobShares[JOBS_MAX_THREADS];
+
+// The job being run, only written while no worker is inside it
+JobFunction jobFunction;
+void *jobContext;
+unsigned int jobItemCount;
+unsigned int jobChunkSize;
+
+volatile unsigned int jobGeneration;     // odd while a job is open to the workers
+volatile unsigned int jobChunksDone;
+volatile unsigned int jobStolenChunks;
+volatile unsigned int jobWorkersInside;  // workers that may be looking at the shares
+volatile unsigned int jobWorkersAsleep;
+volatile unsigned int jobsShouldExit;
+
+#if defined(_WIN32)
+HANDLE jobThreads[JOBS_MAX_THREADS];
+CRITICAL_SECTION jobLock;
+CONDITION_VARIABLE jobWake;
+#else
+pthread_t jobThreads[JOBS_MAX_THREADS];
+pthread_mutex_t jobLock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t jobWake = PTHREAD_COND_INITIALIZER;
+#endif
+
+void RunJobChunks(unsigned int self); // Own share first, then steal until every share is empty
+bool TakeJobChunk(unsigned int self, unsigned int *chunk);
+bool StealJobChunks(unsigned int self, unsigned int *chunk); // Half of another share, the first chunk is returned
+void WaitForJob(unsigned int seen); // Spin, then sleep until a job other than seen is open
+bool IsJobOpen(unsigned int generation, unsigned int seen);
+unsigned long long PackJobRange(unsigned int begin, unsigned int end);
+void PauseCpu(void);
+void LockJobs(void);
+void UnlockJobs(void);
+void WakeJobWorkers(void);
+void WaitJobWorkers(void); // Sleep until woken, with the lock held
+bool StartJobThread(unsigned int index);
+void JoinJobThread(unsigned int index);
+#if defined(_WIN32)
+DWORD WINAPI RunJobWorker(LPVOID index);
+#else
+void *RunJobWorker(void *index);
+#endif
+
+// Sequentially consistent atomics, C99 has none of its own
+unsigned int LoadAtomic(volatile unsigned int *value);
+void StoreAtomic(volatile unsigned int *value, unsigned int desired);
+unsigned int AddAtomic(volatile unsigned int *value, unsigned int amount); // Returns the new value
+unsigned long long LoadAtomic64(volatile unsigned long long *value);
+void StoreAtomic64(volatile unsigned long long *value, unsigned long long desired);
+bool CompareExchangeAtomic64(volatile unsigned long long *value, unsigned long long expected, unsigned long long desired);
+
+void InitJobSystem(unsigned int threadCount)
+{
+    if (threadCount == 0) threadCount = GetCpuCount();
+    if (threadCount > JOBS_MAX_THREADS) threadCount = JOBS_MAX_THREADS;
+    if (threadCount < 1) threadCount = 1;
+
+    jobs = (JobSystem){ .threadCount = 1 };
+    jobGeneration = 0;
+    jobsShouldExit = 0;
+#if defined(_WIN32)
+    InitializeCriticalSection(&jobLock);
+    InitializeConditionVariable(&jobWake);
+#endif
+
+    // Thread 0 is the one calling RunParallelFor()
+    for (unsigned int i = 1; i < threadCount; i++)
+    {
+        if (!StartJobThread(i)) break;
+        jobs.threadCount++;
+    }
+}
+
+void FreeJobSystem(void)
+{
+    LockJobs();
+    StoreAtomic(&jobsShouldExit, 1);
+    WakeJobWorkers();
+    UnlockJobs();
+
+    for (unsigned int i = 1; i < jobs.threadCount; i++)
+        JoinJobThread(i);
+
+#if defined(_WIN32)
+    DeleteCriticalSection(&jobLock);
+#endif
+    jobs.threadCount = 1;
+}
+
+void RunParallelFor(JobFunction function, void *context, unsigned int itemCount, unsigned int chunkSize)
+{
+    unsigned int chunkCount = (itemCount + chunkSize - 1)/chunkSize;
+    if (jobs.threadCount == 1 || chunkCount <= 1)
+    {
+        RunChunksInOrder(function, context, itemCount, chunkSize);
+        return;
+    }
+
+    jobFunction = function;
+    jobContext = context;
+    jobItemCount = itemCount;
+    jobChunkSize = chunkSize;
+    StoreAtomic(&jobChunksDone, 0);
+    StoreAtomic(&jobStolenChunks, 0);
+
+    // Even shares, stealing evens out the rest
+    unsigned int threadCount = jobs.threadCount;
+    for (unsigned int t = 0; t < threadCount; t++)
+        StoreAtomic64(&jobShares[t].range, PackJobRange(t*chunkCount/threadCount, (t + 1)*chunkCount/threadCount));
+
+    // Open the job, waking the workers that gave up spinning
+    AddAtomic(&jobGeneration, 1);
+    if (LoadAtomic(&jobWorkersAsleep) > 0)
+    {
+        LockJobs();
+        WakeJobWorkers();
+        UnlockJobs();
+    }
+
+    RunJobChunks(0);
+    while (LoadAtomic(&jobChunksDone) < chunkCount)
+        PauseCpu();
+
+    // Close it, and wait for the workers still looking for chunks to leave
+    AddAtomic(&jobGeneration, 1);
+    while (LoadAtomic(&jobWorkersInside) > 0)
+        PauseCpu();
+
+    jobs.jobCount++;
+    jobs.stealCount += LoadAtomic(&jobStolenChunks);
+}
+
+unsigned int GetCpuCount(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (unsigned int)info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0)? (unsigned int)count : 1;
+#endif
+}
+
+void RunJobChunks(unsigned int self)
+{
+    unsigned int chunk;
+    while (TakeJobChunk(self, &chunk) || StealJobChunks(self, &chunk))
+    {
+        unsigned int begin = chunk*jobChunkSize;
+        unsigned int end = (jobItemCount - begin > jobChunkSize)? begin + jobChunkSize : jobItemCount;
+        jobFunction(jobContext, chunk, begin, end);
+        AddAtomic(&jobChunksDone, 1);
+    }
+}
+
+bool TakeJobChunk(unsigned int self, unsigned int *chunk)
+{
+    volatile unsigned long long *share = &jobShares[self].range;
+    for (;;)
+    {
+        unsigned long long range = LoadAtomic64(share);
+        unsigned int begin = (unsigned int)range;
+        unsigned int end = (unsigned int)(range >> 32);
+        if (begin >= end) return false;
+
+        if (CompareExchangeAtomic64(share, range, PackJobRange(begin + 1, end)))
+        {
+            *chunk = begin;
+            return true;
+        }
+    }
+}
+
+bool StealJobChunks(unsigned int self, unsigned int *chunk)
+{
+    unsigned int threadCount = jobs.threadCount;
+    for (unsigned int v = 1; v < threadCount; v++)
+    {
+        volatile unsigned long long *victim = &jobShares[(self + v)%threadCount].range;
+        for (;;)
+        {
+            unsigned long long range = LoadAtomic64(victim);
+            unsigned int begin = (unsigned int)range;
+            unsigned int end = (unsigned int)(range >> 32);
+            if (begin >= end) break; // nothing left, try the next one
+
+            // The back half, the bigger one when it's uneven so a last single chunk can be stolen too
+            unsigned int middle = begin + (end - begin)/2;
+            if (!CompareExchangeAtomic64(victim, range, PackJobRange(begin, middle))) continue;
+
+            // Only this thread takes from the front of its own (empty) share
+            StoreAtomic64(&jobShares[self].range, PackJobRange(middle + 1, end));
+            AddAtomic(&jobStolenChunks, end - middle);
+            *chunk = middle;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void WaitForJob(unsigned int seen)
+{
+    for (unsigned int spin = 0; spin < JOBS_SPIN_COUNT; spin++)
+    {
+        if (IsJobOpen(LoadAtomic(&jobGeneration), seen) || LoadAtomic(&jobsShouldExit)) return;
+        PauseCpu();
+    }
+
+    // Counted as asleep before checking again, so RunParallelFor() either
+    // sees it and wakes it, or opened the job before this check
+    LockJobs();
+    AddAtomic(&jobWorkersAsleep, 1);
+    while (!IsJobOpen(LoadAtomic(&jobGeneration), seen) && !LoadAtomic(&jobsShouldExit))
+        WaitJobWorkers();
+    AddAtomic(&jobWorkersAsleep, (unsigned int)-1);
+    UnlockJobs();
+}
+
+bool IsJobOpen(unsigned int generation, unsigned int seen)
+{
+    return (generation & 1) && generation != seen;
+}
+
+unsigned long long PackJobRange(unsigned int begin, unsigned int end)
+{
+    return ((unsigned long long)end << 32) | begin;
+}
+
+#if defined(_WIN32)
+DWORD WINAPI RunJobWorker(LPVOID index)
+#else
+void *RunJobWorker(void *index)
+#endif
+{
+    unsigned int self = (unsigned int)(size_t)index;
+    unsigned int seen = 0;
+
+    for (;;)
+    {
+        WaitForJob(seen);
+        if (LoadAtomic(&jobsShouldExit)) break;
+
+        // Inside before looking at the generation, so a job can't be closed
+        // and the next one set up while this thread is still at the shares
+        AddAtomic(&jobWorkersInside, 1);
+        unsigned int generation = LoadAtomic(&jobGeneration);
+        if (IsJobOpen(generation, seen))
+        {
+            RunJobChunks(self);
+            seen = generation;
+        }
+        AddAtomic(&jobWorkersInside, (unsigned int)-1);
+    }
+
+    return 0;
+}
+
+void PauseCpu(void)
+{
+#if defined(_MSC_VER)
+    YieldProcessor();
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+#if defined(_WIN32)
+void LockJobs(void) { EnterCriticalSection(&jobLock); }
+void UnlockJobs(void) { LeaveCriticalSection(&jobLock); }
+void WakeJobWorkers(void) { WakeAllConditionVariable(&jobWake); }
+void WaitJobWorkers(void) { SleepConditionVariableCS(&jobWake, &jobLock, INFINITE); }
+
+bool StartJobThread(unsigned int index)
+{
+    jobThreads[index] = CreateThread(NULL, 0, RunJobWorker, (LPVOID)(size_t)index, 0, NULL);
+    return jobThreads[index] != NULL;
+}
+
+void JoinJobThread(unsigned int index)
+{
+    WaitForSingleObject(jobThreads[index], INFINITE);
+    CloseHandle(jobThreads[index]);
+}
+#else
+void LockJobs(void) { pthread_mutex_lock(&jobLock); }
+void UnlockJobs(void) { pthread_mutex_unlock(&jobLock); }
+void WakeJobWorkers(void) { pthread_cond_broadcast(&jobWake); }
+void WaitJobWorkers(void) { pthread_cond_wait(&jobWake, &jobLock); }
+
+bool StartJobThread(unsigned int index)
+{
+    return pthread_create(&jobThreads[index], NULL, RunJobWorker, (void *)(size_t)index) == 0;
+}
+
+void JoinJobThread(unsigned int index)
+{
+    pthread_join(jobThreads[index], NULL);
+}
+#endif
+
+#if defined(_MSC_VER)
+unsigned int LoadAtomic(volatile unsigned int *value) { return (unsigned int)InterlockedCompareExchange((volatile LONG *)value, 0, 0); }
+void StoreAtomic(volatile unsigned int *value, unsigned int desired) { InterlockedExchange((volatile LONG *)value, (LONG)desired); }
+unsigned int AddAtomic(volatile unsigned int *value, unsigned int amount) { return (unsigned int)InterlockedExchangeAdd((volatile LONG *)value, (LONG)amount) + amount; }
+unsigned long long LoadAtomic64(volatile unsigned long long *value) { return (unsigned long long)InterlockedCompareExchange64((volatile LONG64 *)value, 0, 0); }
+void StoreAtomic64(volatile unsigned long long *value, unsigned long long desired) { InterlockedExchange64((volatile LONG64 *)value, (LONG64)desired); }
+bool CompareExchangeAtomic64(volatile unsigned long long *value, unsigned long long expected, unsigned long long desired)
+{
+    return (unsigned long long)InterlockedCompareExchange64((volatile LONG64 *)value, (LONG64)desired, (LONG64)expected) == expected;
+}
+#else
+unsigned int LoadAtomic(volatile unsigned int *value) { return __atomic_load_n(value, __ATOMIC_SEQ_CST); }
+void StoreAtomic(volatile unsigned int *value, unsigned int desired) { __atomic_store_n(value, desired, __ATOMIC_SEQ_CST); }
+unsigned int AddAtomic(volatile unsigned int *value, unsigned int amount) { return __atomic_add_fetch(value, amount, __ATOMIC_SEQ_CST); }
+unsigned long long LoadAtomic64(volatile unsigned long long *value) { return __atomic_load_n(value, __ATOMIC_SEQ_CST); }
+void StoreAtomic64(volatile unsigned long long *value, unsigned long long desired) { __atomic_store_n(value, desired, __ATOMIC_SEQ_CST); }
+bool CompareExchangeAtomic64(volatile unsigned long long *value, unsigned long long expected, unsigned long long desired)
+{
+    return __atomic_compare_exchange_n(value, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+#endif
+
+#else // no worker threads
+
+void InitJobSystem(unsigned int threadCount)
+{
+    (void)threadCount;
+    jobs = (JobSystem){ .threadCount = 1 };
+}
+
+void FreeJobSystem(void)
+{
+}
+
+void RunParallelFor(JobFunction function, void *context, unsigned int itemCount, unsigned int chunkSize)
+{
+    RunChunksInOrder(function, context, itemCount, chunkSize);
+}
+
+unsigned int GetCpuCount(void)
+{
+    return 1;
+}
+
+#endif // JOBS_ENABLED
+
+void RunChunksInOrder(JobFunction function, void *context, unsigned int itemCount, unsigned int chunkSize)
+{
+    unsigned int chunk = 0;
+    for (unsigned int begin = 0; begin < itemCount; begin += chunkSize, chunk++)
+    {
+        unsigned int end = (itemCount - begin > chunkSize)? begin + chunkSize : itemCount;
+        function(context, chunk, begin, end);
+    }
+}
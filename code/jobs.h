@@ -0,0 +1,46 @@
+// EXPLANATION:
+// Small work-stealing job system for the simulation's parallel phases
+// - RunParallelFor() cuts a range of items into chunks and gives every thread
+//   an equal share of them. A thread that finishes its share steals half of
+//   what's left of another thread's, so uneven chunks still balance out
+// - The calling thread works too, and only returns once every chunk is done
+// - Chunks are cut by the item count and chunk size alone, never by the
+//   number of threads. A job that only writes to its own chunk's items, or to
+//   per-item outputs merged in order afterwards, gives the same result on any
+//   number of threads
+// - Without JOBS_ENABLED (see config.h), with one thread or with a single
+//   chunk, the chunks run on the calling thread in order
+// - Doesn't include raylib.h, windows.h is needed for the threads on Windows
+
+#ifndef ASTEROIDS_JOBS_HEADER_GUARD
+#define ASTEROIDS_JOBS_HEADER_GUARD
+
+#include <stdbool.h>
+
+// Macros
+// ----------------------------------------------------------------------------
+#define JOBS_MAX_THREADS 32   // calling thread included
+#define JOBS_SPIN_COUNT 20000 // polls for the next job before a worker goes to sleep, keeps one tick's phases from waking it each time
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+
+// Runs the items [begin, end) of one chunk
+typedef void (*JobFunction)(void *context, unsigned int chunk, unsigned int begin, unsigned int end);
+
+typedef struct JobSystem {
+    unsigned int threadCount; // calling thread included, 1 until InitJobSystem()
+    unsigned long long jobCount;   // RunParallelFor() calls that went to the workers
+    unsigned long long stealCount; // chunks run by a thread they weren't handed to
+} JobSystem;
+
+extern JobSystem jobs; // global declaration
+
+// Prototypes
+// ----------------------------------------------------------------------------
+void InitJobSystem(unsigned int threadCount); // 0 for one thread per core, starts the workers
+void FreeJobSystem(void); // Stops and joins the workers
+void RunParallelFor(JobFunction function, void *context, unsigned int itemCount, unsigned int chunkSize);
+unsigned int GetCpuCount(void);
+
+#endif // ASTEROIDS_JOBS_HEADER_GUARD
@@ -0,0 +1,332 @@
+// EXPLANATION:
+// Batch kernels for the simulation's per-entity loops
+// See kernels.h for more documentation/descriptions
+
+#include "kernels.h"
+
+#include "collision.h"
+#include "config.h"
+
+#if defined(SIMD_ENABLED)
+    #if defined(__AVX__)
+        #include <immintrin.h>
+        #define KERNELS_AVX
+        #if defined(__AVX2__)
+            #define KERNELS_AVX2 // gathers
+        #endif
+        #define KERNELS_SSE2 // for the leftovers and the indexed kernels
+    #elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #include <emmintrin.h>
+        #define KERNELS_SSE2
+    #elif defined(__wasm_simd128__)
+        #include <wasm_simd128.h>
+        #define KERNELS_WASM
+    #endif
+#endif
+
+// Local Functions Declaration
+// ----------------------------------------------------------------------------
+void MoveCircle(Vector2 *position, Vector2 velocity, float deltaTime); // The scalar path
+
+// Two circles in one register as x0 y0 x1 y1
+#if defined(KERNELS_SSE2)
+__m128 MoveCirclePair(__m128 position, __m128 velocity, __m128 step);
+#elif defined(KERNELS_WASM)
+v128_t MoveCirclePair(v128_t position, v128_t velocity, v128_t step);
+#endif
+
+// Circles in lanes, one register for each of x, y and radius. Returns a bit per lane that hits
+#if defined(KERNELS_AVX2)
+int CheckCircleOctet(__m256 x, __m256 y, __m256 r, Vector2 center, float radius);
+#endif
+#if defined(KERNELS_SSE2)
+int CheckCircleQuad(__m128 x, __m128 y, __m128 r, Vector2 center, float radius);
+#elif defined(KERNELS_WASM)
+int CheckCircleQuad(v128_t x, v128_t y, v128_t r, Vector2 center, float radius);
+#endif
+
+void MoveCircles(Vector2 *position, const Vector2 *velocity, unsigned int count, float deltaTime)
+{
+    unsigned int i = 0;
+
+#if defined(KERNELS_AVX)
+    // Four circles a step, x and y stay interleaved like in the arrays
+    __m256 size = _mm256_setr_ps(VIRTUAL_WIDTH, VIRTUAL_HEIGHT, VIRTUAL_WIDTH, VIRTUAL_HEIGHT,
+                                 VIRTUAL_WIDTH, VIRTUAL_HEIGHT, VIRTUAL_WIDTH, VIRTUAL_HEIGHT);
+    __m256 zero = _mm256_setzero_ps();
+    __m256 step = _mm256_set1_ps(deltaTime);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256 moved = _mm256_add_ps(_mm256_loadu_ps(&position[i].x), _mm256_mul_ps(_mm256_loadu_ps(&velocity[i].x), step));
+
+        // Wrap: add the size where below 0, then take it off where above it
+        moved = _mm256_add_ps(moved, _mm256_and_ps(_mm256_cmp_ps(moved, zero, _CMP_LT_OQ), size));
+        moved = _mm256_sub_ps(moved, _mm256_and_ps(_mm256_cmp_ps(moved, size, _CMP_GT_OQ), size));
+        _mm256_storeu_ps(&position[i].x, moved);
+    }
+#endif
+
+#if defined(KERNELS_SSE2)
+    __m128 step2 = _mm_set1_ps(deltaTime);
+    for (; i + 2 <= count; i += 2)
+        _mm_storeu_ps(&position[i].x, MoveCirclePair(_mm_loadu_ps(&position[i].x), _mm_loadu_ps(&velocity[i].x), step2));
+#elif defined(KERNELS_WASM)
+    v128_t step2 = wasm_f32x4_splat(deltaTime);
+    for (; i + 2 <= count; i += 2)
+        wasm_v128_store(&position[i].x, MoveCirclePair(wasm_v128_load(&position[i].x), wasm_v128_load(&velocity[i].x), step2));
+#endif
+
+    for (; i < count; i++)
+        MoveCircle(&position[i], velocity[i], deltaTime);
+}
+
+void MoveCirclesIndexed(Vector2 *position, const Vector2 *velocity, const unsigned int *ids, unsigned int count, float deltaTime)
+{
+    unsigned int i = 0;
+
+    // Two circles a step, gathered from their slots
+#if defined(KERNELS_SSE2)
+    __m128 zero = _mm_setzero_ps();
+    __m128 step = _mm_set1_ps(deltaTime);
+    for (; i + 2 <= count; i += 2)
+    {
+        unsigned int a = ids[i];
+        unsigned int b = ids[i + 1];
+        __m128 current = _mm_loadh_pi(_mm_loadl_pi(zero, (const __m64 *)&position[a]), (const __m64 *)&position[b]);
+        __m128 speed = _mm_loadh_pi(_mm_loadl_pi(zero, (const __m64 *)&velocity[a]), (const __m64 *)&velocity[b]);
+        __m128 moved = MoveCirclePair(current, speed, step);
+        _mm_storel_pi((__m64 *)&position[a], moved);
+        _mm_storeh_pi((__m64 *)&position[b], moved);
+    }
+#elif defined(KERNELS_WASM)
+    v128_t step = wasm_f32x4_splat(deltaTime);
+    for (; i + 2 <= count; i += 2)
+    {
+        unsigned int a = ids[i];
+        unsigned int b = ids[i + 1];
+        v128_t current = wasm_f32x4_make(position[a].x, position[a].y, position[b].x, position[b].y);
+        v128_t speed = wasm_f32x4_make(velocity[a].x, velocity[a].y, velocity[b].x, velocity[b].y);
+        v128_t moved = MoveCirclePair(current, speed, step);
+        position[a] = (Vector2){ wasm_f32x4_extract_lane(moved, 0), wasm_f32x4_extract_lane(moved, 1) };
+        position[b] = (Vector2){ wasm_f32x4_extract_lane(moved, 2), wasm_f32x4_extract_lane(moved, 3) };
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        unsigned int id = ids[i];
+        MoveCircle(&position[id], velocity[id], deltaTime);
+    }
+}
+
+unsigned int CheckCirclesToroidal(Vector2 center, float radius, const Vector2 *positions, const float *radii,
+                                  const unsigned int *ids, unsigned int count)
+{
+    unsigned int hits = 0;
+    unsigned int i = 0;
+    if (count > KERNEL_MAX_BATCH) count = KERNEL_MAX_BATCH;
+
+#if defined(KERNELS_AVX2)
+    // Eight a step, gathered from their slots (or from the next eight)
+    __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i index = ids? _mm256_loadu_si256((const __m256i *)&ids[i]) : _mm256_add_epi32(_mm256_set1_epi32((int)i), lanes);
+        __m256i component = _mm256_add_epi32(index, index); // two floats per Vector2
+        __m256 x = _mm256_i32gather_ps(&positions->x, component, 4);
+        __m256 y = _mm256_i32gather_ps(&positions->y, component, 4);
+        __m256 r = _mm256_i32gather_ps(radii, index, 4);
+        hits |= (unsigned int)CheckCircleOctet(x, y, r, center, radius) << i;
+    }
+#endif
+
+#if defined(KERNELS_SSE2)
+    // Four a step, x and y split out of the interleaved positions
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x, y, r;
+        if (ids)
+        {
+            const unsigned int *id = &ids[i];
+            x = _mm_setr_ps(positions[id[0]].x, positions[id[1]].x, positions[id[2]].x, positions[id[3]].x);
+            y = _mm_setr_ps(positions[id[0]].y, positions[id[1]].y, positions[id[2]].y, positions[id[3]].y);
+            r = _mm_setr_ps(radii[id[0]], radii[id[1]], radii[id[2]], radii[id[3]]);
+        }
+        else
+        {
+            __m128 first = _mm_loadu_ps(&positions[i].x);  // x0 y0 x1 y1
+            __m128 second = _mm_loadu_ps(&positions[i + 2].x); // x2 y2 x3 y3
+            x = _mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0));
+            y = _mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1));
+            r = _mm_loadu_ps(&radii[i]);
+        }
+        hits |= (unsigned int)CheckCircleQuad(x, y, r, center, radius) << i;
+    }
+#elif defined(KERNELS_WASM)
+    for (; i + 4 <= count; i += 4)
+    {
+        v128_t x, y, r;
+        if (ids)
+        {
+            const unsigned int *id = &ids[i];
+            x = wasm_f32x4_make(positions[id[0]].x, positions[id[1]].x, positions[id[2]].x, positions[id[3]].x);
+            y = wasm_f32x4_make(positions[id[0]].y, positions[id[1]].y, positions[id[2]].y, positions[id[3]].y);
+            r = wasm_f32x4_make(radii[id[0]], radii[id[1]], radii[id[2]], radii[id[3]]);
+        }
+        else
+        {
+            v128_t first = wasm_v128_load(&positions[i].x);
+            v128_t second = wasm_v128_load(&positions[i + 2].x);
+            x = wasm_i32x4_shuffle(first, second, 0, 2, 4, 6);
+            y = wasm_i32x4_shuffle(first, second, 1, 3, 5, 7);
+            r = wasm_v128_load(&radii[i]);
+        }
+        hits |= (unsigned int)CheckCircleQuad(x, y, r, center, radius) << i;
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        unsigned int id = ids? ids[i] : i;
+        hits |= (unsigned int)CheckCollisionCirclesToroidal(positions[id], radii[id], center, radius) << i;
+    }
+
+    return hits;
+}
+
+unsigned int FindFirstCircleHit(Vector2 center, float radius, const Vector2 *positions, const float *radii,
+                                const unsigned int *ids, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; i += KERNEL_MAX_BATCH)
+    {
+        unsigned int batch = (count - i < KERNEL_MAX_BATCH)? count - i : KERNEL_MAX_BATCH;
+        unsigned int hits = ids? CheckCirclesToroidal(center, radius, positions, radii, &ids[i], batch)
+                               : CheckCirclesToroidal(center, radius, &positions[i], &radii[i], 0, batch);
+        if (hits == 0) continue;
+
+        // Hits are rare, walk to the lowest bit
+        unsigned int first = i;
+        for (; !(hits & 1); hits >>= 1) first++;
+        return first;
+    }
+
+    return count;
+}
+
+const char *GetKernelInstructionSet(void)
+{
+#if defined(KERNELS_AVX2)
+    return "AVX2";
+#elif defined(KERNELS_AVX)
+    return "AVX";
+#elif defined(KERNELS_SSE2)
+    return "SSE2";
+#elif defined(KERNELS_WASM)
+    return "SIMD128";
+#else
+    return "scalar";
+#endif
+}
+
+void MoveCircle(Vector2 *position, Vector2 velocity, float deltaTime)
+{
+    position->x += velocity.x*deltaTime;
+    position->y += velocity.y*deltaTime;
+
+    if (position->x < 0) position->x += VIRTUAL_WIDTH;
+    if (position->x > VIRTUAL_WIDTH) position->x -= VIRTUAL_WIDTH;
+    if (position->y < 0) position->y += VIRTUAL_HEIGHT;
+    if (position->y > VIRTUAL_HEIGHT) position->y -= VIRTUAL_HEIGHT;
+}
+
+#if defined(KERNELS_SSE2)
+__m128 MoveCirclePair(__m128 position, __m128 velocity, __m128 step)
+{
+    __m128 size = _mm_setr_ps(VIRTUAL_WIDTH, VIRTUAL_HEIGHT, VIRTUAL_WIDTH, VIRTUAL_HEIGHT);
+    __m128 zero = _mm_setzero_ps();
+
+    __m128 moved = _mm_add_ps(position, _mm_mul_ps(velocity, step));
+
+    // Wrap: add the size where below 0, then take it off where above it
+    moved = _mm_add_ps(moved, _mm_and_ps(_mm_cmplt_ps(moved, zero), size));
+    moved = _mm_sub_ps(moved, _mm_and_ps(_mm_cmpgt_ps(moved, size), size));
+    return moved;
+}
+#elif defined(KERNELS_WASM)
+v128_t MoveCirclePair(v128_t position, v128_t velocity, v128_t step)
+{
+    v128_t size = wasm_f32x4_make(VIRTUAL_WIDTH, VIRTUAL_HEIGHT, VIRTUAL_WIDTH, VIRTUAL_HEIGHT);
+    v128_t zero = wasm_f32x4_splat(0.0f);
+
+    v128_t moved = wasm_f32x4_add(position, wasm_f32x4_mul(velocity, step));
+
+    // Wrap: add the size where below 0, then take it off where above it
+    moved = wasm_f32x4_add(moved, wasm_v128_and(wasm_f32x4_lt(moved, zero), size));
+    moved = wasm_f32x4_sub(moved, wasm_v128_and(wasm_f32x4_gt(moved, size), size));
+    return moved;
+}
+#endif
+
+// Same steps as CheckCollisionCirclesToroidal(), with the lanes' circles as
+// center1 and the one tested as center2, so every lane agrees with it bit for bit
+#if defined(KERNELS_AVX2)
+int CheckCircleOctet(__m256 x, __m256 y, __m256 r, Vector2 center, float radius)
+{
+    __m256 centerX = _mm256_set1_ps(center.x);
+    __m256 centerY = _mm256_set1_ps(center.y);
+
+    // Offset to the nearest clone: the size where past half of it, minus the size where before minus half
+    __m256 dx = _mm256_sub_ps(centerX, x);
+    __m256 dy = _mm256_sub_ps(centerY, y);
+    __m256 offsetX = _mm256_or_ps(_mm256_and_ps(_mm256_cmp_ps(dx, _mm256_set1_ps(VIRTUAL_WIDTH/2.0f), _CMP_GT_OQ), _mm256_set1_ps(VIRTUAL_WIDTH)),
+                                  _mm256_and_ps(_mm256_cmp_ps(dx, _mm256_set1_ps(-VIRTUAL_WIDTH/2.0f), _CMP_LT_OQ), _mm256_set1_ps(-VIRTUAL_WIDTH)));
+    __m256 offsetY = _mm256_or_ps(_mm256_and_ps(_mm256_cmp_ps(dy, _mm256_set1_ps(VIRTUAL_HEIGHT/2.0f), _CMP_GT_OQ), _mm256_set1_ps(VIRTUAL_HEIGHT)),
+                                  _mm256_and_ps(_mm256_cmp_ps(dy, _mm256_set1_ps(-VIRTUAL_HEIGHT/2.0f), _CMP_LT_OQ), _mm256_set1_ps(-VIRTUAL_HEIGHT)));
+    dx = _mm256_sub_ps(centerX, _mm256_add_ps(x, offsetX));
+    dy = _mm256_sub_ps(centerY, _mm256_add_ps(y, offsetY));
+
+    __m256 distanceSquared = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+    __m256 radiusSum = _mm256_add_ps(r, _mm256_set1_ps(radius));
+    return _mm256_movemask_ps(_mm256_cmp_ps(distanceSquared, _mm256_mul_ps(radiusSum, radiusSum), _CMP_LE_OQ));
+}
+#endif
+
+#if defined(KERNELS_SSE2)
+int CheckCircleQuad(__m128 x, __m128 y, __m128 r, Vector2 center, float radius)
+{
+    __m128 centerX = _mm_set1_ps(center.x);
+    __m128 centerY = _mm_set1_ps(center.y);
+
+    __m128 dx = _mm_sub_ps(centerX, x);
+    __m128 dy = _mm_sub_ps(centerY, y);
+    __m128 offsetX = _mm_or_ps(_mm_and_ps(_mm_cmpgt_ps(dx, _mm_set1_ps(VIRTUAL_WIDTH/2.0f)), _mm_set1_ps(VIRTUAL_WIDTH)),
+                               _mm_and_ps(_mm_cmplt_ps(dx, _mm_set1_ps(-VIRTUAL_WIDTH/2.0f)), _mm_set1_ps(-VIRTUAL_WIDTH)));
+    __m128 offsetY = _mm_or_ps(_mm_and_ps(_mm_cmpgt_ps(dy, _mm_set1_ps(VIRTUAL_HEIGHT/2.0f)), _mm_set1_ps(VIRTUAL_HEIGHT)),
+                               _mm_and_ps(_mm_cmplt_ps(dy, _mm_set1_ps(-VIRTUAL_HEIGHT/2.0f)), _mm_set1_ps(-VIRTUAL_HEIGHT)));
+    dx = _mm_sub_ps(centerX, _mm_add_ps(x, offsetX));
+    dy = _mm_sub_ps(centerY, _mm_add_ps(y, offsetY));
+
+    __m128 distanceSquared = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+    __m128 radiusSum = _mm_add_ps(r, _mm_set1_ps(radius));
+    return _mm_movemask_ps(_mm_cmple_ps(distanceSquared, _mm_mul_ps(radiusSum, radiusSum)));
+}
+#elif defined(KERNELS_WASM)
+int CheckCircleQuad(v128_t x, v128_t y, v128_t r, Vector2 center, float radius)
+{
+    v128_t centerX = wasm_f32x4_splat(center.x);
+    v128_t centerY = wasm_f32x4_splat(center.y);
+
+    v128_t dx = wasm_f32x4_sub(centerX, x);
+    v128_t dy = wasm_f32x4_sub(centerY, y);
+    v128_t offsetX = wasm_v128_or(wasm_v128_and(wasm_f32x4_gt(dx, wasm_f32x4_splat(VIRTUAL_WIDTH/2.0f)), wasm_f32x4_splat(VIRTUAL_WIDTH)),
+                                  wasm_v128_and(wasm_f32x4_lt(dx, wasm_f32x4_splat(-VIRTUAL_WIDTH/2.0f)), wasm_f32x4_splat(-VIRTUAL_WIDTH)));
+    v128_t offsetY = wasm_v128_or(wasm_v128_and(wasm_f32x4_gt(dy, wasm_f32x4_splat(VIRTUAL_HEIGHT/2.0f)), wasm_f32x4_splat(VIRTUAL_HEIGHT)),
+                                  wasm_v128_and(wasm_f32x4_lt(dy, wasm_f32x4_splat(-VIRTUAL_HEIGHT/2.0f)), wasm_f32x4_splat(-VIRTUAL_HEIGHT)));
+    dx = wasm_f32x4_sub(centerX, wasm_f32x4_add(x, offsetX));
+    dy = wasm_f32x4_sub(centerY, wasm_f32x4_add(y, offsetY));
+
+    v128_t distanceSquared = wasm_f32x4_add(wasm_f32x4_mul(dx, dx), wasm_f32x4_mul(dy, dy));
+    v128_t radiusSum = wasm_f32x4_add(r, wasm_f32x4_splat(radius));
+    return (int)wasm_i32x4_bitmask(wasm_f32x4_le(distanceSquared, wasm_f32x4_mul(radiusSum, radiusSum)));
+}
+#endif
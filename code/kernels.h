@@ -0,0 +1,42 @@
+// EXPLANATION:
+// Batch kernels for the simulation's per-entity loops
+// - Work on whole pool arrays, a few entities per instruction where the
+//   target has SIMD: AVX, SSE2, or SIMD128 on the web (see SIMD_ENABLED in
+//   config.h). Anything else, and the leftovers of each batch, run a scalar loop
+// - Every path does the same float operations in the same order, so the
+//   results match bit for bit whichever one the build picked, and replays
+//   recorded on one build play back the same on another. That needs the
+//   compiler to leave multiplies and adds unfused, the builds pass
+//   -ffp-contract=off (/fp:precise on MSVC) for it
+// - AVX is only used when the compiler targets it, e.g. -mavx2 or -march=native.
+//   The circle tests need AVX2 for its gathers and use SSE2 without it
+
+#ifndef ASTEROIDS_KERNELS_HEADER_GUARD
+#define ASTEROIDS_KERNELS_HEADER_GUARD
+
+#include "raylib.h"
+
+// Macros
+// ----------------------------------------------------------------------------
+#define KERNEL_MAX_BATCH 32 // circles one CheckCirclesToroidal() call tests, a bit each in its mask
+
+// Prototypes
+// ----------------------------------------------------------------------------
+
+// Move circles by velocity*deltaTime, then wrap them back on screen.
+// Same as WrapPastEdge() on each one, without the branches
+void MoveCircles(Vector2 *position, const Vector2 *velocity, unsigned int count, float deltaTime);
+void MoveCirclesIndexed(Vector2 *position, const Vector2 *velocity, const unsigned int *ids,
+                        unsigned int count, float deltaTime); // Only the circles listed in ids
+
+// Test one circle against a batch of others, 4 or 8 at a time, with the same
+// math as CheckCollisionCirclesToroidal() (squared distances, no sqrt).
+// The others are ids[0] up to ids[count - 1], or the first count when ids is 0
+unsigned int CheckCirclesToroidal(Vector2 center, float radius, const Vector2 *positions, const float *radii,
+                                  const unsigned int *ids, unsigned int count); // Bit k set if the k-th one hits, up to KERNEL_MAX_BATCH of them
+unsigned int FindFirstCircleHit(Vector2 center, float radius, const Vector2 *positions, const float *radii,
+                                const unsigned int *ids, unsigned int count); // Any count, returns the first one hit or count if none
+
+const char *GetKernelInstructionSet(void); // The SIMD the build uses, for logs and benchmarks
+
+#endif // ASTEROIDS_KERNELS_HEADER_GUARD
@@ -0,0 +1,199 @@
+// EXPLANATION:
+// Input latency measurement
+// See latency.h for more documentation/descriptions
+
+#include "latency.h"
+
+#if defined(LATENCY_ENABLED)
+
+#include <stdlib.h> // for qsort
+
+#include "asteroids.h"
+
+#define LATENCY_SUMMARY_INTERVAL 0.5 // seconds between overlay refreshes
+
+// Globals
+// ----------------------------------------------------------------------------
+LatencyState latency = { 0 };
+
+static const char *latencyKindNames[LATENCY_KIND_COUNT] = {
+    [LATENCY_SHOOT] = "shoot",
+    [LATENCY_THRUST] = "thrust",
+};
+
+// Local Functions Declaration
+// ----------------------------------------------------------------------------
+void AddLatencyPending(LatencyKind kind, unsigned int entity, double pressTime);
+void RemoveLatencyPending(unsigned int index); // Swaps the last one in
+LatencyPercentiles GetLatencyPercentiles(const float *samplesMs, unsigned int count);
+int CompareFloats(const void *a, const void *b);
+
+void StartLatencyMeasurement(void)
+{
+    latency = (LatencyState){ .isMeasuring = true };
+    TraceLog(LOG_INFO, "LATENCY: Measuring input latency, vsync %s, max framerate %d, %d ticks per second",
+             VSYNC_ENABLED? "on" : "off", MAX_FRAMERATE, SIM_TICK_RATE);
+}
+
+void TagLatencyTick(const TickInput *input, unsigned int nextShotBefore)
+{
+    if (!latency.isMeasuring) return;
+
+    // ShootMissile() takes the slot at nextShot, so a change means this tick fired
+    if (IsTickActionPressed(input, INPUT_ACTION_SHOOT) && game.missiles.nextShot != nextShotBefore)
+        AddLatencyPending(LATENCY_SHOOT, nextShotBefore, GetInputPressTime(INPUT_ACTION_SHOOT));
+
+    if (IsTickActionPressed(input, INPUT_ACTION_FORWARD) && game.ship.isThrusting && !game.ship.exploded)
+        AddLatencyPending(LATENCY_THRUST, 0, GetInputPressTime(INPUT_ACTION_FORWARD));
+}
+
+void MarkLatencySubmitted(LatencyKind kind, unsigned int entity)
+{
+    for (unsigned int i = 0; i < latency.pendingCount; i++)
+    {
+        LatencyPending *pending = &latency.pending[i];
+        if (pending->kind == kind && pending->entity == entity && pending->submitTime == 0.0)
+            pending->submitTime = GetTime();
+    }
+}
+
+void MarkLatencyPresented(void)
+{
+    if (latency.pendingCount == 0) return;
+
+    double now = GetTime();
+    for (unsigned int i = 0; i < latency.pendingCount; )
+    {
+        LatencyPending *pending = &latency.pending[i];
+        if (pending->submitTime > 0.0)
+        {
+            LatencyHistory *history = &latency.history[pending->kind];
+            history->submitMs[history->next] = (float)((pending->submitTime - pending->pressTime)*1000.0);
+            history->presentMs[history->next] = (float)((now - pending->pressTime)*1000.0);
+            history->next = (history->next + 1)%LATENCY_HISTORY;
+            if (history->count < LATENCY_HISTORY) history->count++;
+            RemoveLatencyPending(i);
+        }
+        else if (now - pending->pressTime > LATENCY_TIMEOUT)
+        {
+            latency.droppedCount++;
+            RemoveLatencyPending(i);
+        }
+        else
+            i++;
+    }
+}
+
+void LogLatencyReport(void)
+{
+    if (!latency.isMeasuring) return;
+
+    TraceLog(LOG_INFO, "LATENCY: Report for vsync %s, max framerate %d, %d ticks per second (ms, press to draw call / to present)",
+             VSYNC_ENABLED? "on" : "off", MAX_FRAMERATE, SIM_TICK_RATE);
+    for (unsigned int kind = 0; kind < LATENCY_KIND_COUNT; kind++)
+    {
+        LatencyHistory *history = &latency.history[kind];
+        if (history->count == 0)
+        {
+            TraceLog(LOG_INFO, "LATENCY:     %-6s no samples", latencyKindNames[kind]);
+            continue;
+        }
+
+        LatencyPercentiles submit = GetLatencyPercentiles(history->submitMs, history->count);
+        LatencyPercentiles present = GetLatencyPercentiles(history->presentMs, history->count);
+        TraceLog(LOG_INFO, "LATENCY:     %-6s %4u samples  submit p50 %6.2f p90 %6.2f p99 %6.2f max %6.2f"
+                           "  present p50 %6.2f p90 %6.2f p99 %6.2f max %6.2f",
+                 latencyKindNames[kind], history->count,
+                 submit.p50, submit.p90, submit.p99, submit.max,
+                 present.p50, present.p90, present.p99, present.max);
+    }
+    if (latency.droppedCount > 0)
+        TraceLog(LOG_INFO, "LATENCY:     %llu presses never got drawn", latency.droppedCount);
+}
+
+void DrawLatencyOverlay(void)
+{
+    if (!latency.isMeasuring) return;
+
+    double now = GetTime();
+    if (now - latency.lastSummaryTime > LATENCY_SUMMARY_INTERVAL)
+    {
+        for (unsigned int kind = 0; kind < LATENCY_KIND_COUNT; kind++)
+        {
+            LatencyHistory *history = &latency.history[kind];
+            latency.submit[kind] = GetLatencyPercentiles(history->submitMs, history->count);
+            latency.present[kind] = GetLatencyPercentiles(history->presentMs, history->count);
+        }
+        latency.lastSummaryTime = now;
+    }
+
+    int lineHeight = LATENCY_FONT_SIZE + 2;
+    int width = 330;
+    int height = (LATENCY_KIND_COUNT + 1)*lineHeight + 10;
+    int x = 5;
+    int y = GetScreenHeight() - height - 5;
+    DrawRectangle(x, y, width, height, Fade(BLACK, 0.75f));
+    x += 5;
+    y += 5;
+
+    DrawText(TextFormat("latency ms  vsync %s  fps cap %d   p50/p99 submit  p50/p99 present",
+                        VSYNC_ENABLED? "on" : "off", MAX_FRAMERATE),
+             x, y, LATENCY_FONT_SIZE, GRAY);
+    y += lineHeight;
+    for (unsigned int kind = 0; kind < LATENCY_KIND_COUNT; kind++)
+    {
+        DrawText(TextFormat("%-6s (%u)", latencyKindNames[kind], latency.history[kind].count),
+                 x, y, LATENCY_FONT_SIZE, RAYWHITE);
+        DrawText(TextFormat("%6.2f / %6.2f", latency.submit[kind].p50, latency.submit[kind].p99),
+                 x + 150, y, LATENCY_FONT_SIZE, RAYWHITE);
+        DrawText(TextFormat("%6.2f / %6.2f", latency.present[kind].p50, latency.present[kind].p99),
+                 x + 240, y, LATENCY_FONT_SIZE, YELLOW);
+        y += lineHeight;
+    }
+}
+
+void AddLatencyPending(LatencyKind kind, unsigned int entity, double pressTime)
+{
+    if (latency.pendingCount == LATENCY_MAX_PENDING)
+    {
+        latency.droppedCount++;
+        return;
+    }
+
+    latency.pending[latency.pendingCount++] = (LatencyPending){
+        .pressTime = pressTime,
+        .entity = entity,
+        .kind = kind,
+    };
+}
+
+void RemoveLatencyPending(unsigned int index)
+{
+    latency.pending[index] = latency.pending[--latency.pendingCount];
+}
+
+LatencyPercentiles GetLatencyPercentiles(const float *samplesMs, unsigned int count)
+{
+    LatencyPercentiles result = { 0 };
+    if (count == 0) return result;
+
+    static float sorted[LATENCY_HISTORY];
+    for (unsigned int i = 0; i < count; i++)
+        sorted[i] = samplesMs[i];
+    qsort(sorted, count, sizeof(float), CompareFloats);
+
+    result.p50 = sorted[count*50/100];
+    result.p90 = sorted[count*90/100];
+    result.p99 = sorted[count*99/100];
+    result.max = sorted[count - 1];
+    return result;
+}
+
+int CompareFloats(const void *a, const void *b)
+{
+    float x = *(const float *)a;
+    float y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+#endif // LATENCY_ENABLED
@@ -0,0 +1,83 @@
+// EXPLANATION:
+// Input latency measurement (--latency)
+// - Times a press of INPUT_ACTION_SHOOT or INPUT_ACTION_FORWARD until the
+//   missile or jet triangle it caused is submitted in DrawGameFrame(), and
+//   until the frame holding it has been presented (EndDrawing() returned)
+// - The press time is when the input event was sampled (see input.h), the
+//   tick that consumes it tags the missile slot or ship it spawned or lit up
+// - Percentiles are shown in an overlay and logged on exit, together with the
+//   frame pacing settings from config.h they were measured with
+
+#ifndef ASTEROIDS_LATENCY_HEADER_GUARD
+#define ASTEROIDS_LATENCY_HEADER_GUARD
+
+#include "config.h"
+#include "input.h"
+
+// Macros
+// ----------------------------------------------------------------------------
+#define LATENCY_MAX_PENDING 32 // presses waiting for their entity to be drawn
+#define LATENCY_HISTORY 4096   // samples kept per kind for the percentiles
+#define LATENCY_TIMEOUT 1.0    // seconds before a press whose entity never got drawn is dropped
+#define LATENCY_FONT_SIZE 10
+
+// Called where the tagged entities are drawn, costs a branch while not measuring
+#if defined(LATENCY_ENABLED)
+    #define LATENCY_SUBMIT(kind, entity) do { if (latency.pendingCount > 0) MarkLatencySubmitted(kind, entity); } while (0)
+#else
+    #define LATENCY_SUBMIT(kind, entity) ((void)0)
+#endif
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+
+typedef enum LatencyKind {
+    LATENCY_SHOOT,  // press to missile, entity is the missile slot
+    LATENCY_THRUST, // press to jet triangle, entity is always 0
+    LATENCY_KIND_COUNT
+} LatencyKind;
+
+typedef struct LatencyPending {
+    double pressTime;  // GetTime() the press was sampled
+    double submitTime; // 0 until the entity is drawn
+    unsigned int entity;
+    LatencyKind kind;
+} LatencyPending;
+
+// Ring buffer of the most recent samples, in milliseconds
+typedef struct LatencyHistory {
+    float submitMs[LATENCY_HISTORY];
+    float presentMs[LATENCY_HISTORY];
+    unsigned int count;
+    unsigned int next;
+} LatencyHistory;
+
+typedef struct LatencyPercentiles {
+    float p50, p90, p99, max;
+} LatencyPercentiles;
+
+typedef struct LatencyState {
+    bool isMeasuring;
+    LatencyPending pending[LATENCY_MAX_PENDING];
+    unsigned int pendingCount;
+    LatencyHistory history[LATENCY_KIND_COUNT];
+    unsigned long long droppedCount; // presses that never got drawn, e.g. the ship was dead
+
+    // Overlay figures, refreshed twice a second
+    LatencyPercentiles submit[LATENCY_KIND_COUNT];
+    LatencyPercentiles present[LATENCY_KIND_COUNT];
+    double lastSummaryTime;
+} LatencyState;
+
+extern LatencyState latency; // global declaration
+
+// Prototypes
+// ----------------------------------------------------------------------------
+void StartLatencyMeasurement(void);
+void TagLatencyTick(const TickInput *input, unsigned int nextShotBefore); // After a tick, before its input is consumed
+void MarkLatencySubmitted(LatencyKind kind, unsigned int entity); // Use LATENCY_SUBMIT() instead
+void MarkLatencyPresented(void); // After EndDrawing()
+void LogLatencyReport(void); // Percentiles of everything measured, on exit
+void DrawLatencyOverlay(void);
+
+#endif // ASTEROIDS_LATENCY_HEADER_GUARD
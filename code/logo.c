@@ -4,6 +4,7 @@
 
 #include "logo.h"
 #include "config.h"
+#include "input.h"
 #include "asteroids.h"
 
 // Global animation state
@@ -40,7 +41,7 @@ void UpdateRaylibLogo(void)
     static bool skipped = false;
 
     // Press any key or click to skip intro
-    if ((GetKeyPressed() != 0) || IsGestureDetected(GESTURE_TAP))
+    if (IsInputAnyKeyPressed() || IsInputTapped())
     {
         if (raylibLogo.state >= LOGO_TEXT)
             game.currentScreen = SCREEN_TITLE;
@@ -4,12 +4,25 @@
 
 #include "raylib.h"
 
+#include "allocator.h" // Heap usage tracking
 #include "config.h" // Program config, e.g. window title/size, fps, vsync
 #include "input.h"  // Input controls / key mappings
+#include "jobs.h"   // Worker threads for the simulation
+#include "latency.h"  // Input latency measurement
 #include "logo.h"   // Raylib logo animation
+#include "platform.h" // Audio for the game simulation
+#include "profiler.h" // Frame timing zones and overlay
+#include "replay.h"   // Input recording and playback
+#include "rewind.h"   // Rewind history of the simulation
+#include "trace.h"    // Chrome trace export
+#include "render.h"   // Cached drawing resources, e.g. the star field
 #include "ui.h"     // User interface (menus and buttons)
 #include "asteroids.h"
 
+#include <stdlib.h> // for getenv, strtoul
+#include <string.h>
+#include <time.h>   // for the session seed
+
 #if defined(PLATFORM_WEB) // for compiling to wasm (web assembly)
     #include <emscripten/emscripten.h>
 #endif
@@ -23,28 +36,58 @@ typedef struct Viewport {
 GameState game; // game data
 UiState   ui;   // user interface data
 Viewport  view; // for rendering within aspect ratio
+RenderCache render; // baked textures
+const char *recordPath = 0; // where the next session's input is saved, 0 if not recording
+double simulationTime = 0.0; // GetTime() the tick accumulator was last advanced to
 
 // Local Functions Declaration
 // ----------------------------------------------------------------------------
 void CreateNewWindow(void); // Creates a new window with the proper initial settings
 void RunGameLoop(void); // Runs the game loop depending on platform
 void UpdateCameraViewport(void);
+void UpdateSimulation(void); // Runs as many fixed-rate game ticks as the elapsed time calls for
+void HoldSimulation(double now); // Drains the input events while nothing is simulated
+bool HasArg(int argc, char **argv, const char *flag);
+const char *GetArgPath(int argc, char **argv, const char *flag, const char *defaultPath); // From flag [file], 0 if not given
+const char *GetTracePath(int argc, char **argv); // From --trace [file] or ASTEROIDS_TRACE, 0 if not tracing
+void UpdateReplayTick(void); // Play back or record the input of the coming tick
+bool UpdateRewindTick(void); // Steps back a tick while rewind is held, true if it did
+void StopRecordingSession(void); // Saves the recorded session, only the first one is kept
 
 void UpdateDrawFrame(void); // Update and Draw the current frame
                             // Most of the game loop's code is found in here
 
 // Main entry point
 // ----------------------------------------------------------------------------
-int main(void)
+int main(int argc, char **argv)
 {
     // Initialization
     // ----------------------------------------------------------------------------
+    const char *tracePath = GetTracePath(argc, argv);
+    const char *replayPath = GetArgPath(argc, argv, "--replay", 0);
+    const char *threadArg = GetArgPath(argc, argv, "--threads", 0);
+    recordPath = GetArgPath(argc, argv, "--record", REPLAY_DEFAULT_PATH);
+
+    unsigned int seed = (unsigned int)time(0);
+    if (replayPath && LoadReplay(replayPath))
+    {
+        seed = replay.seed;
+        recordPath = 0; // the replay is already on disk
+    }
+
+    InitJobSystem(threadArg? (unsigned int)strtoul(threadArg, 0, 10) : 0); // --threads N, one per core by default
     CreateNewWindow();
-    InitAudioDevice();
+    InitGameAudio(); // also allocates memory for beep sound effects
     InitDefaultInputControls();
     InitRaylibLogo();
     InitUiState();   // also allocates memory for menu buttons
-    InitGameState(); // also allocates memory for beep sound effects
+    InitGameState(seed); // also allocates memory for entities
+    InitRewindBuffer(); // allocates the whole history budget
+    InitRenderCache(); // generates rock shapes
+
+    // Replays start straight into the recorded session
+    if (replay.mode == REPLAY_PLAYING)
+        ChangeUiMenu(UI_MENU_GAMEPLAY);
 
     // No exit key (use alt+F4 or in-game exit option)
     SetExitKey(KEY_NULL);
@@ -52,15 +95,41 @@ int main(void)
     // Debug:
     SetExitKey(KEY_Q);
 
+#if defined(LATENCY_ENABLED)
+    if (HasArg(argc, argv, "--latency") && replay.mode != REPLAY_PLAYING)
+        StartLatencyMeasurement();
+#endif
+
+#if defined(TRACE_ENABLED)
+    if (tracePath)
+        StartTrace(tracePath, profileZoneNames, PROFILE_ZONE_COUNT);
+#else
+    if (tracePath)
+        TraceLog(LOG_WARNING, "TRACE: Tracing is not available in this build");
+#endif
+
     // Start the game loop
     // (See UpdateDrawFrame() for the full game loop)
     RunGameLoop();
 
+#if defined(TRACE_ENABLED)
+    StopTrace();
+#endif
+
     // De-Initialization
     // ----------------------------------------------------------------------------
+#if defined(LATENCY_ENABLED)
+    LogLatencyReport();
+#endif
+    StopRecordingSession();
+    FreeReplay();
+    FreeRewindBuffer();
     FreeGameState();
+    FreeRenderCache();
     FreeUiState();
-    CloseAudioDevice();
+    FreeGameAudio();
+    FreeJobSystem();
+    LogAllocSites(LOG_DEBUG);
     CloseWindow(); // Close window and OpenGL context
 
     return 0;
@@ -85,14 +154,24 @@ void RunGameLoop(void)
                                  // Generally, it will use whatever the monitor's refresh rate is
     emscripten_set_main_loop(UpdateDrawFrame, emscriptenFPS, 1);
 #else
-    if (MAX_FRAMERATE > 0)
-        SetTargetFPS(MAX_FRAMERATE);
+    // Frames are paced here rather than with SetTargetFPS(), so input keeps
+    // being polled and timestamped while waiting for the next frame
+    double frameTime = (MAX_FRAMERATE > 0)? 1.0/MAX_FRAMERATE : 0.0;
+    double nextFrameTime = GetTime();
     // ----------------------------------------------------------------------------
 
     // Main game loop
     while (!WindowShouldClose() && !game.gameShouldExit) // Detect window close button
     {
         UpdateDrawFrame();
+
+        if (frameTime > 0.0)
+        {
+            nextFrameTime += frameTime;
+            double now = GetTime();
+            if (nextFrameTime < now) nextFrameTime = now; // fell behind, don't rush to catch up
+            WaitAndSampleInput(nextFrameTime);
+        }
     }
 #endif
 }
@@ -122,23 +201,175 @@ void UpdateCameraViewport(void)
 
     game.camera.offset = (Vector2){ view.x + view.width/2.0f, view.y + view.height/2.0f };
     game.camera.zoom   = (float)view.width/VIRTUAL_WIDTH;
+
+    // Keep the stars at one texel per screen pixel
+    BakeStarField(view.width, view.height);
+}
+
+bool HasArg(int argc, char **argv, const char *flag)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], flag) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+const char *GetArgPath(int argc, char **argv, const char *flag, const char *defaultPath)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], flag) == 0)
+            return (i + 1 < argc && argv[i + 1][0] != '-')? argv[i + 1] : defaultPath;
+    }
+
+    return 0;
+}
+
+const char *GetTracePath(int argc, char **argv)
+{
+    const char *path = GetArgPath(argc, argv, "--trace", TRACE_DEFAULT_PATH);
+    if (path)
+        return path;
+
+    path = getenv("ASTEROIDS_TRACE");
+    if (path && path[0] != '\0')
+        return path;
+
+    return 0;
+}
+
+void UpdateSimulation(void)
+{
+    double now = GetTime();
+
+    // Leaving the game ends the session
+    if (game.currentScreen != SCREEN_GAMEPLAY)
+    {
+        StopRecordingSession();
+        ClearRewindBuffer();
+    }
+
+    // Menus may have paused or left the game this frame
+    if (game.isPaused || game.currentScreen != SCREEN_GAMEPLAY)
+    {
+        HoldSimulation(now);
+        return;
+    }
+
+    float frameTime = (simulationTime > 0.0)? (float)(now - simulationTime) : 0.0f;
+    if (frameTime > SIM_MAX_FRAME_TIME)
+        frameTime = SIM_MAX_FRAME_TIME;
+    game.tickAccumulator += frameTime;
+    simulationTime = now;
+
+    // Each tick takes the input events sampled up to the moment it ends
+    double tickEndTime = now - game.tickAccumulator + SIM_TICK_TIME;
+    while (game.tickAccumulator >= SIM_TICK_TIME)
+    {
+        ApplyInputEvents(&game.input, tickEndTime);
+        if (UpdateRewindTick())
+        {
+            ConsumeTickInput(&game.input); // presses while rewinding don't carry over
+        }
+        else
+        {
+            UpdateReplayTick();
+            unsigned int nextShot = game.missiles.nextShot;
+            UpdateGameTick();
+#if defined(LATENCY_ENABLED)
+            TagLatencyTick(&game.input, nextShot);
+#else
+            (void)nextShot;
+#endif
+            ConsumeTickInput(&game.input); // each press acts on one tick only
+            RecordRewindTick();
+        }
+        game.tickAccumulator -= SIM_TICK_TIME;
+        tickEndTime += SIM_TICK_TIME;
+    }
+
+    game.tickAlpha = game.tickAccumulator/SIM_TICK_TIME;
+}
+
+void HoldSimulation(double now)
+{
+    ApplyInputEvents(&game.input, now); // keep track of what's held
+    ConsumeTickInput(&game.input); // don't act on menu input when resuming
+    game.tickAccumulator = 0.0f;
+    simulationTime = now;
+}
+
+void UpdateReplayTick(void)
+{
+    if (replay.mode == REPLAY_PLAYING)
+    {
+        if (!PlayReplayTick(&game.input))
+        {
+            TraceLog(LOG_INFO, "REPLAY: Playback finished, back to live input");
+            FreeReplay();
+        }
+    }
+    else if (recordPath)
+    {
+        if (replay.mode != REPLAY_RECORDING)
+            StartRecording(game.seed, 0);
+        RecordReplayTick(&game.input);
+    }
+}
+
+bool UpdateRewindTick(void)
+{
+    // Recorded and played back sessions have to run every tick in order
+    if (recordPath || replay.mode != REPLAY_OFF) return false;
+
+    if (!IsTickActionDown(&game.input, INPUT_ACTION_REWIND)) return false;
+
+    StepRewind(); // holds on the oldest tick once the history runs out
+    return true;
+}
+
+void StopRecordingSession(void)
+{
+    if (replay.mode != REPLAY_RECORDING) return;
+
+    SaveReplay(recordPath);
+    FreeReplay();
+    recordPath = 0;
 }
 
 // Update game data and draw elements to the screen for the current frame
 void UpdateDrawFrame(void)
 {
+    PROFILE_FRAME();
+    PROFILE_BEGIN(PROFILE_ZONE_UPDATE_DRAW_FRAME);
+    BeginAllocFrame();
+
     // Update
     // ----------------------------------------------------------------------------
+    UpdateInputActions(); // everything below reads this frame's action bitsets
     HandleToggleFullscreen();
+#if defined(PROFILER_ENABLED)
+    HandleToggleProfiler();
+#endif
     UpdateCameraViewport();
 
     switch(game.currentScreen)
     {
         case SCREEN_LOGO:     UpdateRaylibLogo();
+                              HoldSimulation(GetTime());
                               break;
         case SCREEN_TITLE:    UpdateUiFrame();
+                              HoldSimulation(GetTime());
                               break;
-        case SCREEN_GAMEPLAY: UpdateGameFrame();
+        case SCREEN_GAMEPLAY: PROFILE_BEGIN(PROFILE_ZONE_UPDATE_GAME_FRAME);
+                              UpdateGameFrame();
+                              PROFILE_END(PROFILE_ZONE_UPDATE_GAME_FRAME);
+                              PROFILE_BEGIN(PROFILE_ZONE_SIMULATION);
+                              UpdateSimulation();
+                              PROFILE_END(PROFILE_ZONE_SIMULATION);
                               break;
         default: break;
     }
@@ -156,9 +387,13 @@ void UpdateDrawFrame(void)
             {
                 case SCREEN_LOGO:     DrawRaylibLogo();
                                       break;
-                case SCREEN_TITLE:    DrawUiFrame();
+                case SCREEN_TITLE:    PROFILE_BEGIN(PROFILE_ZONE_DRAW_UI_FRAME);
+                                      DrawUiFrame();
+                                      PROFILE_END(PROFILE_ZONE_DRAW_UI_FRAME);
                                       break;
-                case SCREEN_GAMEPLAY: DrawGameFrame();
+                case SCREEN_GAMEPLAY: PROFILE_BEGIN(PROFILE_ZONE_DRAW_GAME_FRAME);
+                                      DrawGameFrame();
+                                      PROFILE_END(PROFILE_ZONE_DRAW_GAME_FRAME);
                                       break;
                 default: break;
             }
@@ -168,6 +403,18 @@ void UpdateDrawFrame(void)
 
     // Debug:
     DrawFPS(0, 0);
+#if defined(PROFILER_ENABLED)
+    DrawProfilerOverlay();
+#endif
+#if defined(LATENCY_ENABLED)
+    DrawLatencyOverlay();
+#endif
 
+    PROFILE_END(PROFILE_ZONE_UPDATE_DRAW_FRAME);
+    PROFILE_BEGIN(PROFILE_ZONE_END_DRAWING);
     EndDrawing();
+    PROFILE_END(PROFILE_ZONE_END_DRAWING);
+#if defined(LATENCY_ENABLED)
+    MarkLatencyPresented();
+#endif
 }
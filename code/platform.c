@@ -0,0 +1,86 @@
+// EXPLANATION:
+// Services the game simulation needs from the program hosting it
+// See platform.h for more documentation/descriptions
+
+#include "platform.h"
+
+#include <limits.h> // for SHRT_MAX for beep sound math
+#include <math.h>   // for sinf
+#include "raylib.h"
+
+#include "allocator.h"
+
+#define ARRAY_SIZE(arr) (sizeof(arr)/sizeof((arr)[0]))
+
+// Globals
+// ----------------------------------------------------------------------------
+Sound beeps[3]; // indexed by GameBeep
+
+// Local Functions Declaration
+// ----------------------------------------------------------------------------
+Sound GenBeep(float freq, float lengthSec); // Generate a sine wave beep
+
+void InitGameAudio(void)
+{
+    InitAudioDevice();
+
+    // Allocate memory for beep sine waves
+    beeps[BEEP_MENU] = GenBeep(300.0f, 0.03f);
+    beeps[BEEP_SHOOT] = GenBeep(400.0f, 0.05f);
+    beeps[BEEP_EXPLODE] = GenBeep(150.0f, EXPLOSION_TIME);
+}
+
+void FreeGameAudio(void)
+{
+    for (unsigned int i = 0; i < ARRAY_SIZE(beeps); i++)
+        UnloadSound(beeps[i]);
+    CloseAudioDevice();
+}
+
+void PlayGameBeep(GameBeep beep)
+{
+    PlaySound(beeps[beep]);
+}
+
+Sound GenBeep(float freq, float lengthSec)
+{
+    unsigned int sampleRate = 44100;
+    unsigned int samples = (int)(lengthSec*sampleRate);
+    short *data = GameAlloc(samples*sizeof(short));
+
+    // fade length in samples
+    // (This prevents an unpleasant "pop" noise when the sound starts or stops)
+    unsigned int fadeSamples = (unsigned int)(0.005f*sampleRate); // 5 ms
+
+    // Generate wave data
+    for (unsigned int i = 0; i < samples; i++)
+    {
+        float timeInSeconds = (float)i/sampleRate;
+        float sample = sinf(2.0f*PI*freq*timeInSeconds);
+
+        // Apply fade in/out
+        float amplitude = 1.0f;
+        if (i < fadeSamples)
+        {
+            amplitude = (float)i/fadeSamples; // fade in
+        }
+        else if (i > samples - fadeSamples)
+        {
+            amplitude = (float)(samples - i)/fadeSamples; // fade out
+        }
+
+        data[i] = (short)(sample*amplitude*SHRT_MAX*0.25f);
+    }
+
+    Wave beepSoundWave = {
+        .frameCount = samples,
+        .sampleRate = sampleRate,
+        .sampleSize = 16,
+        .channels = 1,
+        .data = data
+    };
+
+    Sound beep = LoadSoundFromWave(beepSoundWave); // copies the data
+    GameFree(data);
+    return beep;
+}
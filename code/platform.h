@@ -0,0 +1,17 @@
+// EXPLANATION:
+// Services the game simulation needs from the program hosting it
+// - Desktop and web builds implement these with raylib in platform.c
+// - The headless build (no window, GL or audio) stubs them in headless/
+
+#ifndef ASTEROIDS_PLATFORM_HEADER_GUARD
+#define ASTEROIDS_PLATFORM_HEADER_GUARD
+
+#include "asteroids.h"
+
+// Prototypes
+// ----------------------------------------------------------------------------
+void InitGameAudio(void); // Opens the audio device and generates the beeps
+void FreeGameAudio(void);
+void PlayGameBeep(GameBeep beep);
+
+#endif // ASTEROIDS_PLATFORM_HEADER_GUARD
@@ -0,0 +1,173 @@
+// EXPLANATION:
+// Lightweight frame profiler
+// See profiler.h for more documentation/descriptions
+
+#include "profiler.h"
+
+// Also names the trace events
+const char *const profileZoneNames[PROFILE_ZONE_COUNT] = {
+    [PROFILE_ZONE_UPDATE_DRAW_FRAME] = "UpdateDrawFrame",
+    [PROFILE_ZONE_UPDATE_GAME_FRAME] = "UpdateGameFrame",
+    [PROFILE_ZONE_SIMULATION] = "Simulation",
+    [PROFILE_ZONE_UPDATE_ASTEROIDS] = "UpdateAsteroids",
+    [PROFILE_ZONE_UPDATE_MISSILES] = "UpdateMissiles",
+    [PROFILE_ZONE_UPDATE_SHIP] = "UpdateShip",
+    [PROFILE_ZONE_COLLISION] = "Collision",
+    [PROFILE_ZONE_DRAW_GAME_FRAME] = "DrawGameFrame",
+    [PROFILE_ZONE_DRAW_UI_FRAME] = "DrawUiFrame",
+    [PROFILE_ZONE_END_DRAWING] = "EndDrawing",
+};
+
+const char *const profileCounterNames[PROFILE_COUNTER_COUNT] = {
+    [PROFILE_COUNTER_WRAP_CLONES] = "wrap clones",
+};
+
+#if defined(PROFILER_ENABLED)
+
+#include "allocator.h"
+#include "input.h"
+#include "rewind.h"
+
+#define PROFILER_FONT_SIZE 10
+#define PROFILER_GRAPH_HEIGHT 60
+#define PROFILER_GRAPH_MAX_MS 33.3f // top of the graph
+#define PROFILER_COLUMN_WIDTH 60    // for the ms columns
+
+// Globals
+// ----------------------------------------------------------------------------
+ProfilerState profiler = { 0 };
+
+void ProfilerBeginFrame(void)
+{
+    double now = GetTime();
+    if (profiler.frameStart > 0.0)
+    {
+        profiler.frames[profiler.frameIndex].frameMs = (float)((now - profiler.frameStart)*1000.0);
+        profiler.frameIndex = (profiler.frameIndex + 1)%PROFILER_HISTORY;
+        if (profiler.frameCount < PROFILER_HISTORY)
+            profiler.frameCount++;
+    }
+
+    profiler.frames[profiler.frameIndex] = (ProfileFrame){ 0 };
+    profiler.frameStart = now;
+
+#if defined(TRACE_ENABLED)
+    FlushTrace();
+#endif
+}
+
+void ProfilerBeginZone(ProfileZone zone)
+{
+    profiler.zoneStart[zone] = GetTime();
+
+#if defined(TRACE_ENABLED)
+    TraceZone(zone, TRACE_PHASE_BEGIN);
+#endif
+}
+
+void ProfilerEndZone(ProfileZone zone)
+{
+#if defined(TRACE_ENABLED)
+    TraceZone(zone, TRACE_PHASE_END);
+#endif
+
+    double elapsed = GetTime() - profiler.zoneStart[zone];
+    profiler.frames[profiler.frameIndex].zoneMs[zone] += (float)(elapsed*1000.0);
+}
+
+#if !defined(PLATFORM_HEADLESS) // no input or screen to draw to
+void HandleToggleProfiler(void)
+{
+    if (IsInputActionPressed(INPUT_ACTION_PROFILER))
+        profiler.isOverlayVisible = !profiler.isOverlayVisible;
+}
+
+void DrawProfilerOverlay(void)
+{
+    if (!profiler.isOverlayVisible || profiler.frameCount == 0) return;
+
+    int lineHeight = PROFILER_FONT_SIZE + 2;
+    int width = PROFILER_HISTORY + 10;
+    int height = (PROFILE_ZONE_COUNT + PROFILE_COUNTER_COUNT + 4)*lineHeight + PROFILER_GRAPH_HEIGHT + 15;
+    int x = 5;
+    int y = 25; // below DrawFPS
+    DrawRectangle(x, y, width, height, Fade(BLACK, 0.75f));
+    x += 5;
+    y += 5;
+
+    // Averages over the history
+    float averageMs[PROFILE_ZONE_COUNT] = { 0 };
+    float averageCounts[PROFILE_COUNTER_COUNT] = { 0 };
+    float averageFrameMs = 0.0f;
+    for (unsigned int f = 0; f < profiler.frameCount; f++)
+    {
+        ProfileFrame *frame = &profiler.frames[(profiler.frameIndex + PROFILER_HISTORY - 1 - f)%PROFILER_HISTORY];
+        averageFrameMs += frame->frameMs/profiler.frameCount;
+        for (unsigned int z = 0; z < PROFILE_ZONE_COUNT; z++)
+            averageMs[z] += frame->zoneMs[z]/profiler.frameCount;
+        for (unsigned int c = 0; c < PROFILE_COUNTER_COUNT; c++)
+            averageCounts[c] += (float)frame->counts[c]/profiler.frameCount;
+    }
+
+    // Per-zone times of the last complete frame, then the average
+    ProfileFrame *last = &profiler.frames[(profiler.frameIndex + PROFILER_HISTORY - 1)%PROFILER_HISTORY];
+    int lastX = x + width - 10 - 2*PROFILER_COLUMN_WIDTH;
+    int averageX = lastX + PROFILER_COLUMN_WIDTH;
+    DrawText("zone", x, y, PROFILER_FONT_SIZE, GRAY);
+    DrawText("last ms", lastX, y, PROFILER_FONT_SIZE, GRAY);
+    DrawText("avg ms", averageX, y, PROFILER_FONT_SIZE, GRAY);
+    y += lineHeight;
+    for (unsigned int z = 0; z < PROFILE_ZONE_COUNT; z++)
+    {
+        DrawText(profileZoneNames[z], x, y, PROFILER_FONT_SIZE, RAYWHITE);
+        DrawText(TextFormat("%.3f", last->zoneMs[z]), lastX, y, PROFILER_FONT_SIZE, RAYWHITE);
+        DrawText(TextFormat("%.3f", averageMs[z]), averageX, y, PROFILER_FONT_SIZE, RAYWHITE);
+        y += lineHeight;
+    }
+    DrawText("frame", x, y, PROFILER_FONT_SIZE, YELLOW);
+    DrawText(TextFormat("%.3f", last->frameMs), lastX, y, PROFILER_FONT_SIZE, YELLOW);
+    DrawText(TextFormat("%.3f", averageFrameMs), averageX, y, PROFILER_FONT_SIZE, YELLOW);
+    y += lineHeight;
+
+    // Counters, per frame
+    for (unsigned int c = 0; c < PROFILE_COUNTER_COUNT; c++)
+    {
+        DrawText(profileCounterNames[c], x, y, PROFILER_FONT_SIZE, RAYWHITE);
+        DrawText(TextFormat("%u", last->counts[c]), lastX, y, PROFILER_FONT_SIZE, RAYWHITE);
+        DrawText(TextFormat("%.1f", averageCounts[c]), averageX, y, PROFILER_FONT_SIZE, RAYWHITE);
+        y += lineHeight;
+    }
+
+    // Heap use, any allocation in the last frame is worth a look
+    Color allocColor = (allocator.lastFrameCount > 0)? RED : RAYWHITE;
+    DrawText(TextFormat("allocs/frame %u   heap %.1f KB   peak %.1f KB", allocator.lastFrameCount,
+                        allocator.bytesInUse/1024.0, allocator.peakBytes/1024.0),
+             x, y, PROFILER_FONT_SIZE, allocColor);
+    y += lineHeight;
+
+    // Rewind history, what a second of it costs decides how much fits the budget
+    DrawText(TextFormat("rewind %.1f s   %.1f KB/s   %.1f/%.1f MB", GetRewindSeconds(),
+                        GetRewindBytesPerSecond()/1024.0f, rewindBuffer.bytesUsed/(1024.0f*1024.0f),
+                        REWIND_BUDGET/(1024.0f*1024.0f)),
+             x, y, PROFILER_FONT_SIZE, RAYWHITE);
+    y += lineHeight + 5;
+
+    // Frame time graph, oldest on the left
+    float scale = PROFILER_GRAPH_HEIGHT/PROFILER_GRAPH_MAX_MS;
+    float budgetMs = 1000.0f/((MAX_FRAMERATE > 0)? MAX_FRAMERATE : 60);
+    int bottom = y + PROFILER_GRAPH_HEIGHT;
+    for (unsigned int f = 0; f < profiler.frameCount; f++)
+    {
+        unsigned int age = profiler.frameCount - 1 - f;
+        ProfileFrame *frame = &profiler.frames[(profiler.frameIndex + PROFILER_HISTORY - 1 - age)%PROFILER_HISTORY];
+        float barHeight = frame->frameMs*scale;
+        if (barHeight > PROFILER_GRAPH_HEIGHT) barHeight = PROFILER_GRAPH_HEIGHT;
+        Color color = (frame->frameMs > budgetMs*1.5f)? RED : GREEN;
+        DrawLine(x + f, bottom, x + f, bottom - (int)barHeight, color);
+    }
+    int budgetY = bottom - (int)(budgetMs*scale);
+    DrawLine(x, budgetY, x + PROFILER_HISTORY, budgetY, Fade(YELLOW, 0.6f));
+}
+#endif
+
+#endif // PROFILER_ENABLED
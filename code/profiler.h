@@ -0,0 +1,93 @@
+// EXPLANATION:
+// Lightweight frame profiler
+// - PROFILE_BEGIN/PROFILE_END time named zones, adding up every time a zone
+//   runs in a frame (e.g. several simulation ticks)
+// - PROFILE_COUNT adds to a named counter, reset every frame (e.g. how
+//   many wrap clones were drawn)
+// - The last PROFILER_HISTORY frames are kept in a ring buffer and shown in
+//   an overlay with per-zone times and a frame time graph
+// - Compiled out of release builds (see PROFILER_ENABLED in config.h),
+//   the macros then only feed the trace export, or expand to nothing
+
+#ifndef ASTEROIDS_PROFILER_HEADER_GUARD
+#define ASTEROIDS_PROFILER_HEADER_GUARD
+
+#include "raylib.h"
+#include "config.h"
+#include "trace.h"
+
+// Macros
+// ----------------------------------------------------------------------------
+#define PROFILER_HISTORY 240 // frames kept for the graph and averages
+
+#if defined(PROFILER_ENABLED)
+    #define PROFILE_FRAME() ProfilerBeginFrame()
+    #define PROFILE_BEGIN(zone) ProfilerBeginZone(zone)
+    #define PROFILE_END(zone) ProfilerEndZone(zone)
+    #define PROFILE_COUNT(counter, amount) (profiler.frames[profiler.frameIndex].counts[counter] += (amount))
+#elif defined(TRACE_ENABLED)
+    #define PROFILE_FRAME() do { if (trace.isRecording) FlushTrace(); } while (0)
+    #define PROFILE_BEGIN(zone) do { if (trace.isRecording) TraceZone(zone, TRACE_PHASE_BEGIN); } while (0)
+    #define PROFILE_END(zone) do { if (trace.isRecording) TraceZone(zone, TRACE_PHASE_END); } while (0)
+    #define PROFILE_COUNT(counter, amount) ((void)0)
+#else
+    #define PROFILE_FRAME() ((void)0)
+    #define PROFILE_BEGIN(zone) ((void)0)
+    #define PROFILE_END(zone) ((void)0)
+    #define PROFILE_COUNT(counter, amount) ((void)0)
+#endif
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+
+typedef enum ProfileZone {
+    PROFILE_ZONE_UPDATE_DRAW_FRAME, // the whole frame except waiting in EndDrawing
+    PROFILE_ZONE_UPDATE_GAME_FRAME,
+    PROFILE_ZONE_SIMULATION, // all of this frame's ticks
+    PROFILE_ZONE_UPDATE_ASTEROIDS,
+    PROFILE_ZONE_UPDATE_MISSILES,
+    PROFILE_ZONE_UPDATE_SHIP,
+    PROFILE_ZONE_COLLISION,
+    PROFILE_ZONE_DRAW_GAME_FRAME,
+    PROFILE_ZONE_DRAW_UI_FRAME,
+    PROFILE_ZONE_END_DRAWING, // includes waiting for vsync/the frame limit
+    PROFILE_ZONE_COUNT
+} ProfileZone;
+
+typedef enum ProfileCounter {
+    PROFILE_COUNTER_WRAP_CLONES, // copies of objects drawn at the opposite side of the screen
+    PROFILE_COUNTER_COUNT
+} ProfileCounter;
+
+typedef struct ProfileFrame {
+    float frameMs; // start of this frame to the start of the next
+    float zoneMs[PROFILE_ZONE_COUNT];
+    unsigned int counts[PROFILE_COUNTER_COUNT];
+} ProfileFrame;
+
+typedef struct ProfilerState {
+    ProfileFrame frames[PROFILER_HISTORY]; // ring buffer, frames[frameIndex] is being recorded
+    double zoneStart[PROFILE_ZONE_COUNT];
+    double frameStart;
+    unsigned int frameIndex;
+    unsigned int frameCount; // completed frames in the ring buffer
+    bool isOverlayVisible;
+} ProfilerState;
+
+extern const char *const profileZoneNames[PROFILE_ZONE_COUNT];
+extern const char *const profileCounterNames[PROFILE_COUNTER_COUNT];
+extern ProfilerState profiler; // global declaration
+
+// Prototypes
+// ----------------------------------------------------------------------------
+
+// Recording (use the macros above)
+void ProfilerBeginFrame(void); // Finish the previous frame's record and start a new one
+void ProfilerBeginZone(ProfileZone zone);
+void ProfilerEndZone(ProfileZone zone);
+
+// Overlay
+void HandleToggleProfiler(void);
+void DrawProfilerOverlay(void); // Draw in screen space, outside of any camera mode
+
+#endif // ASTEROIDS_PROFILER_HEADER_GUARD
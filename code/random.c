@@ -0,0 +1,76 @@
+// EXPLANATION:
+// The game's own random number generator
+// See random.h for more documentation/descriptions
+
+#include "random.h"
+
+// Local Functions Declaration
+// ----------------------------------------------------------------------------
+unsigned long long SplitMix64(unsigned long long *state); // Spreads a seed over the generator state
+unsigned int RotateLeft(unsigned int x, int k);
+
+void SeedRandomStream(RandomStream *stream, unsigned int seed, RandomStreamId id)
+{
+    unsigned long long mix = ((unsigned long long)id << 32) | seed;
+    unsigned long long a = SplitMix64(&mix);
+    unsigned long long b = SplitMix64(&mix);
+
+    stream->state[0] = (unsigned int)a;
+    stream->state[1] = (unsigned int)(a >> 32);
+    stream->state[2] = (unsigned int)b;
+    stream->state[3] = (unsigned int)(b >> 32);
+
+    // An all zero state would only ever give zeros
+    if ((stream->state[0] | stream->state[1] | stream->state[2] | stream->state[3]) == 0)
+        stream->state[0] = 1;
+}
+
+unsigned int GetRandomBits(RandomStream *stream)
+{
+    unsigned int *s = stream->state;
+    unsigned int result = RotateLeft(s[1]*5, 7)*9;
+    unsigned int t = s[1] << 9;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = RotateLeft(s[3], 11);
+
+    return result;
+}
+
+int GetRandomInt(RandomStream *stream, int min, int max)
+{
+    if (min > max)
+    {
+        int tmp = max;
+        max = min;
+        min = tmp;
+    }
+
+    // Scale into the range with a multiply instead of a modulo
+    unsigned long long range = (unsigned long long)((long long)max - min) + 1;
+    return (int)((long long)min + (long long)((GetRandomBits(stream)*range) >> 32));
+}
+
+float GetRandomFloat(RandomStream *stream, float min, float max)
+{
+    // Top 24 bits, all a float can hold exactly
+    float unit = (GetRandomBits(stream) >> 8)*(1.0f/16777216.0f);
+    return min + (max - min)*unit;
+}
+
+unsigned long long SplitMix64(unsigned long long *state)
+{
+    unsigned long long z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30))*0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27))*0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+unsigned int RotateLeft(unsigned int x, int k)
+{
+    return (x << k) | (x >> (32 - k));
+}
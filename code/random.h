@@ -0,0 +1,34 @@
+// EXPLANATION:
+// The game's own random number generator (xoshiro128**)
+// - Seeded from the session seed given to InitGameState(), so a session
+//   plays out the same for the same seed and input (see replay.h)
+// - Separate streams keep unrelated draws from shifting each other, e.g.
+//   giving rocks a new shade of brown never changes where they fly
+// - Replaces raylib's GetRandomValue(), which shares one global state and
+//   does a modulo per call
+
+#ifndef ASTEROIDS_RANDOM_HEADER_GUARD
+#define ASTEROIDS_RANDOM_HEADER_GUARD
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+
+typedef enum RandomStreamId {
+    RANDOM_WORLD,    // new waves of rocks
+    RANDOM_GAMEPLAY, // everything else the simulation decides, e.g. how rocks split
+    RANDOM_COSMETIC, // looks only, e.g. stars and rock shades
+    RANDOM_STREAM_COUNT
+} RandomStreamId;
+
+typedef struct RandomStream {
+    unsigned int state[4];
+} RandomStream;
+
+// Prototypes
+// ----------------------------------------------------------------------------
+void SeedRandomStream(RandomStream *stream, unsigned int seed, RandomStreamId id); // Each id gets an unrelated sequence
+unsigned int GetRandomBits(RandomStream *stream); // Next 32 random bits
+int GetRandomInt(RandomStream *stream, int min, int max); // min to max, both included
+float GetRandomFloat(RandomStream *stream, float min, float max); // min included, max excluded
+
+#endif // ASTEROIDS_RANDOM_HEADER_GUARD
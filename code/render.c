@@ -0,0 +1,419 @@
+// EXPLANATION:
+// Drawing resources that are built once and reused every frame
+// See render.h for more documentation/descriptions
+
+#include "render.h"
+
+#include <math.h> // for cosf, sinf
+#include <stdio.h> // for snprintf
+#include "raymath.h" // for MatrixMultiply
+#include "rlgl.h" // for instancing, and batching the rock triangles without it
+
+#include "config.h"
+#include "asteroids.h"
+
+// Globals
+// ----------------------------------------------------------------------------
+
+// Rock shaders, after a #version line that depends on the OpenGL version and
+// the SHAPE_ defines. Each vertex of the fan is a corner index, the center is -1
+static const char *rockVertexCode =
+    "in float vertexCorner;\n"
+    "in vec4 instanceRock;\n" // position x, y, radius and rotation
+    "in float instanceShape;\n"
+    "in vec4 instanceColor;\n"
+    "uniform mat4 mvp;\n"
+    "uniform vec2 rockShapes[SHAPE_COUNT*SHAPE_VERTICES];\n"
+    "out vec4 fragColor;\n"
+    "void main()\n"
+    "{\n"
+    "    int corner = int(vertexCorner);\n"
+    "    vec2 local = (corner < 0)? vec2(0.0) : rockShapes[int(instanceShape)*SHAPE_VERTICES + corner];\n"
+    "    float c = cos(instanceRock.w);\n"
+    "    float s = sin(instanceRock.w);\n"
+    "    vec2 turned = vec2(local.x*c - local.y*s, local.x*s + local.y*c)*instanceRock.z;\n"
+    "    fragColor = instanceColor;\n"
+    "    gl_Position = mvp*vec4(instanceRock.xy + turned, 0.0, 1.0);\n"
+    "}\n";
+
+static const char *rockFragmentCode =
+    "in vec4 fragColor;\n"
+    "out vec4 finalColor;\n"
+    "void main()\n"
+    "{\n"
+    "    finalColor = fragColor;\n"
+    "}\n";
+
+// Circle shaders, same as the rocks'.
+// The quad corners go from -1 to 1, so the distance to the circle's edge is
+// length - 1 in radii. fwidth() of that is about a pixel, for the smooth edge
+static const char *circleVertexCode =
+    "in vec2 vertexCorner;\n"
+    "in vec3 instanceCircle;\n" // center x, y and radius
+    "in vec4 instanceColor;\n"
+    "uniform mat4 mvp;\n"
+    "out vec2 fragCorner;\n"
+    "out vec4 fragColor;\n"
+    "void main()\n"
+    "{\n"
+    "    fragCorner = vertexCorner;\n"
+    "    fragColor = instanceColor;\n"
+    "    gl_Position = mvp*vec4(instanceCircle.xy + vertexCorner*instanceCircle.z, 0.0, 1.0);\n"
+    "}\n";
+
+static const char *circleFragmentCode =
+    "in vec2 fragCorner;\n"
+    "in vec4 fragColor;\n"
+    "out vec4 finalColor;\n"
+    "void main()\n"
+    "{\n"
+    "    float distance = length(fragCorner) - 1.0;\n"
+    "    float coverage = 1.0 - smoothstep(-fwidth(distance), 0.0, distance);\n"
+    "    if (coverage <= 0.0) discard;\n"
+    "    finalColor = vec4(fragColor.rgb, fragColor.a*coverage);\n"
+    "}\n";
+
+// Local Functions Declaration
+// ----------------------------------------------------------------------------
+float GetShapeNoise(unsigned int seed); // 0 to 1, same result for a seed on every run
+unsigned int LoadInstancingShader(const char *defines, const char *vertexCode, const char *fragmentCode); // 0 if the GPU can't
+void LoadRockInstancing(void);   // Leaves isRockInstanced false if the GPU can't
+void LoadCircleInstancing(void); // Leaves isCircleInstanced false if the GPU can't
+void DrawRockImmediate(const RockInstance *rock); // Through raylib's vertex batch
+void DrawStarsToTexture(void); // game.stars into render.starField, the whole texture
+
+void InitRenderCache(void)
+{
+    render = (RenderCache){ 0 };
+
+    // Evenly spaced corners, each pushed in or out a bit.
+    // Uses a hash instead of game.random so the game's random sequences
+    // are the same whether or not anything is drawn
+    for (unsigned int s = 0; s < ROCK_SHAPE_COUNT; s++)
+    {
+        Vector2 *outline = &render.rockShapes[s*ROCK_SHAPE_VERTICES];
+        float farthest = 0.0f;
+        for (unsigned int i = 0; i < ROCK_SHAPE_VERTICES; i++)
+        {
+            float angle = (i + 0.4f*GetShapeNoise(s*ROCK_SHAPE_VERTICES*2 + i))*2*PI/ROCK_SHAPE_VERTICES;
+            float distance = 0.8f + 0.3f*GetShapeNoise(s*ROCK_SHAPE_VERTICES*2 + ROCK_SHAPE_VERTICES + i);
+            outline[i] = (Vector2){ cosf(angle)*distance, sinf(angle)*distance };
+            if (distance > farthest) farthest = distance;
+        }
+
+        // Farthest corner on the unit circle, so a rock never reaches past
+        // its collision circle or past the box its wrap clones are picked by
+        for (unsigned int i = 0; i < ROCK_SHAPE_VERTICES; i++)
+            outline[i] = (Vector2){ outline[i].x/farthest, outline[i].y/farthest };
+    }
+
+    LoadRockInstancing();
+    LoadCircleInstancing();
+}
+
+void FreeRenderCache(void)
+{
+    if (render.isStarFieldBaked)
+        UnloadRenderTexture(render.starField);
+    if (render.isRockInstanced)
+    {
+        rlUnloadVertexArray(render.rockVao);
+        rlUnloadVertexBuffer(render.rockFanVbo);
+        rlUnloadVertexBuffer(render.rockInstanceVbo);
+        rlUnloadShaderProgram(render.rockShader);
+    }
+    if (render.isCircleInstanced)
+    {
+        rlUnloadVertexArray(render.circleVao);
+        rlUnloadVertexBuffer(render.circleQuadVbo);
+        rlUnloadVertexBuffer(render.circleInstanceVbo);
+        rlUnloadShaderProgram(render.circleShader);
+    }
+    render = (RenderCache){ 0 };
+}
+
+void BakeStarField(int width, int height)
+{
+    if (width <= 0 || height <= 0) return; // minimized
+    if (render.isStarFieldBaked &&
+        render.starField.texture.width == width && render.starField.texture.height == height)
+        return;
+
+    if (render.isStarFieldBaked)
+        UnloadRenderTexture(render.starField);
+    render.starField = LoadRenderTexture(width, height);
+    render.isStarFieldBaked = true;
+    DrawStarsToTexture();
+}
+
+void DrawStarsToTexture(void)
+{
+    // Scale the game world down to the texture, like the game camera does to the viewport
+    Camera2D camera = { .zoom = (float)render.starField.texture.width/VIRTUAL_WIDTH };
+
+    BeginTextureMode(render.starField);
+    ClearBackground(BLANK);
+        BeginMode2D(camera);
+        for (unsigned int i = 0; i < STAR_AMOUNT; i++)
+            DrawCircleV(game.stars[i], 1.0f, WHITE);
+        EndMode2D();
+    EndTextureMode();
+}
+
+void RebakeStarField(void)
+{
+    if (!render.isStarFieldBaked) return; // the first BakeStarField() will draw them
+
+    DrawStarsToTexture();
+}
+
+void DrawStarField(void)
+{
+    if (!render.isStarFieldBaked) return;
+
+    // Render textures are stored upside down, flip the source
+    Texture2D texture = render.starField.texture;
+    Rectangle source = { 0, 0, (float)texture.width, -(float)texture.height };
+    Rectangle dest = { 0, 0, VIRTUAL_WIDTH, VIRTUAL_HEIGHT };
+    DrawTexturePro(texture, source, dest, (Vector2){ 0, 0 }, 0.0f, WHITE);
+}
+
+unsigned int GetRockShape(SizeOfAsteroid size, unsigned int slot)
+{
+    return size*ROCK_SHAPE_VARIANTS + slot%ROCK_SHAPE_VARIANTS;
+}
+
+void QueueRock(unsigned int shape, Vector2 position, float radius, float rotation, Color color)
+{
+    if (render.rockCount == ROCK_BATCH_SIZE)
+        DrawRockBatch();
+
+    render.rocks[render.rockCount++] = (RockInstance){ position, radius, rotation*DEG2RAD, (float)shape, color };
+}
+
+void DrawRockBatch(void)
+{
+    if (render.rockCount == 0) return;
+
+    if (!render.isRockInstanced)
+    {
+        for (unsigned int i = 0; i < render.rockCount; i++)
+            DrawRockImmediate(&render.rocks[i]);
+        render.rockCount = 0;
+        return;
+    }
+
+    // Draw what's waiting in raylib's batch first, so the rocks go on top of it
+    rlDrawRenderBatchActive();
+
+    // Same transform raylib's batch gets, camera included
+    Matrix mvp = MatrixMultiply(MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview()), rlGetMatrixProjection());
+
+    rlEnableShader(render.rockShader);
+    rlSetUniformMatrix(render.rockMvpLocation, mvp);
+    rlEnableVertexArray(render.rockVao);
+    rlUpdateVertexBuffer(render.rockInstanceVbo, render.rocks, render.rockCount*sizeof(RockInstance), 0);
+    rlDrawVertexArrayInstanced(0, ROCK_SHAPE_VERTICES*3, render.rockCount);
+    rlDisableVertexArray();
+    rlDisableShader();
+
+    render.rockCount = 0;
+}
+
+void QueueCircle(Vector2 center, float radius, Color color)
+{
+    if (render.circleCount == CIRCLE_BATCH_SIZE)
+        DrawCircleBatch();
+
+    render.circles[render.circleCount++] = (CircleInstance){ center, radius, color };
+}
+
+void DrawCircleBatch(void)
+{
+    if (render.circleCount == 0) return;
+
+    if (!render.isCircleInstanced)
+    {
+        for (unsigned int i = 0; i < render.circleCount; i++)
+            DrawCircleV(render.circles[i].center, render.circles[i].radius, render.circles[i].color);
+        render.circleCount = 0;
+        return;
+    }
+
+    // Draw what's waiting in raylib's batch first, so the circles go on top of it
+    rlDrawRenderBatchActive();
+
+    // Same transform raylib's batch gets, camera included
+    Matrix mvp = MatrixMultiply(MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview()), rlGetMatrixProjection());
+
+    rlEnableShader(render.circleShader);
+    rlSetUniformMatrix(render.circleMvpLocation, mvp);
+    rlEnableVertexArray(render.circleVao);
+    rlUpdateVertexBuffer(render.circleInstanceVbo, render.circles, render.circleCount*sizeof(CircleInstance), 0);
+    rlDrawVertexArrayInstanced(0, 6, render.circleCount);
+    rlDisableVertexArray();
+    rlDisableShader();
+
+    render.circleCount = 0;
+}
+
+void LoadCircleInstancing(void)
+{
+    unsigned int shader = LoadInstancingShader("", circleVertexCode, circleFragmentCode);
+    if (shader == 0)
+    {
+        TraceLog(LOG_INFO, "RENDER: No circle shader, circles are drawn one by one");
+        return;
+    }
+
+    // Two triangles covering the unit circle
+    static const float corners[12] = { -1, -1,  1, -1,  1, 1,   -1, -1,  1, 1,  -1, 1 };
+    int cornerLocation = rlGetLocationAttrib(shader, "vertexCorner");
+    int circleLocation = rlGetLocationAttrib(shader, "instanceCircle");
+    int colorLocation = rlGetLocationAttrib(shader, "instanceColor");
+
+    render.circleShader = shader;
+    render.circleMvpLocation = rlGetLocationUniform(shader, "mvp");
+    render.circleVao = rlLoadVertexArray();
+    rlEnableVertexArray(render.circleVao);
+
+    render.circleQuadVbo = rlLoadVertexBuffer(corners, sizeof(corners), false);
+    rlEnableVertexAttribute(cornerLocation);
+    rlSetVertexAttribute(cornerLocation, 2, RL_FLOAT, false, 0, 0);
+
+    // One CircleInstance per quad
+    render.circleInstanceVbo = rlLoadVertexBuffer(0, sizeof(render.circles), true);
+    rlEnableVertexAttribute(circleLocation);
+    rlSetVertexAttribute(circleLocation, 3, RL_FLOAT, false, sizeof(CircleInstance), 0);
+    rlSetVertexAttributeDivisor(circleLocation, 1);
+    rlEnableVertexAttribute(colorLocation);
+    rlSetVertexAttribute(colorLocation, 4, RL_UNSIGNED_BYTE, true, sizeof(CircleInstance), sizeof(Vector2) + sizeof(float));
+    rlSetVertexAttributeDivisor(colorLocation, 1);
+
+    rlDisableVertexArray();
+    rlDisableVertexBuffer();
+
+    render.isCircleInstanced = true;
+}
+
+void LoadRockInstancing(void)
+{
+    char defines[128];
+    snprintf(defines, sizeof(defines), "#define SHAPE_COUNT %d\n#define SHAPE_VERTICES %d\n", ROCK_SHAPE_COUNT, ROCK_SHAPE_VERTICES);
+    unsigned int shader = LoadInstancingShader(defines, rockVertexCode, rockFragmentCode);
+    if (shader == 0)
+    {
+        TraceLog(LOG_INFO, "RENDER: No rock shader, rocks go through raylib's vertex batch");
+        return;
+    }
+
+    // Triangle fan around the center, in the same winding as DrawCircleV
+    float fan[ROCK_SHAPE_VERTICES*3];
+    for (unsigned int i = 0; i < ROCK_SHAPE_VERTICES; i++)
+    {
+        fan[i*3] = -1.0f;
+        fan[i*3 + 1] = (float)((i + 1)%ROCK_SHAPE_VERTICES);
+        fan[i*3 + 2] = (float)i;
+    }
+    int cornerLocation = rlGetLocationAttrib(shader, "vertexCorner");
+    int rockLocation = rlGetLocationAttrib(shader, "instanceRock");
+    int shapeLocation = rlGetLocationAttrib(shader, "instanceShape");
+    int colorLocation = rlGetLocationAttrib(shader, "instanceColor");
+
+    // The outlines never change, they're uploaded once
+    render.rockShader = shader;
+    render.rockMvpLocation = rlGetLocationUniform(shader, "mvp");
+    rlEnableShader(shader);
+    rlSetUniform(rlGetLocationUniform(shader, "rockShapes"), render.rockShapes, RL_SHADER_UNIFORM_VEC2,
+                 ROCK_SHAPE_COUNT*ROCK_SHAPE_VERTICES);
+    rlDisableShader();
+
+    render.rockVao = rlLoadVertexArray();
+    rlEnableVertexArray(render.rockVao);
+
+    render.rockFanVbo = rlLoadVertexBuffer(fan, sizeof(fan), false);
+    rlEnableVertexAttribute(cornerLocation);
+    rlSetVertexAttribute(cornerLocation, 1, RL_FLOAT, false, 0, 0);
+
+    // One RockInstance per fan
+    render.rockInstanceVbo = rlLoadVertexBuffer(0, sizeof(render.rocks), true);
+    rlEnableVertexAttribute(rockLocation);
+    rlSetVertexAttribute(rockLocation, 4, RL_FLOAT, false, sizeof(RockInstance), 0);
+    rlSetVertexAttributeDivisor(rockLocation, 1);
+    rlEnableVertexAttribute(shapeLocation);
+    rlSetVertexAttribute(shapeLocation, 1, RL_FLOAT, false, sizeof(RockInstance), 4*sizeof(float));
+    rlSetVertexAttributeDivisor(shapeLocation, 1);
+    rlEnableVertexAttribute(colorLocation);
+    rlSetVertexAttribute(colorLocation, 4, RL_UNSIGNED_BYTE, true, sizeof(RockInstance), 5*sizeof(float));
+    rlSetVertexAttributeDivisor(colorLocation, 1);
+
+    rlDisableVertexArray();
+    rlDisableVertexBuffer();
+
+    render.isRockInstanced = true;
+}
+
+unsigned int LoadInstancingShader(const char *defines, const char *vertexCode, const char *fragmentCode)
+{
+    // Instanced arrays and fwidth() are core from OpenGL 3.3 and ES 3.0 on
+    const char *version;
+    switch (rlGetVersion())
+    {
+        case RL_OPENGL_33:
+        case RL_OPENGL_43: version = "#version 330\n"; break;
+        case RL_OPENGL_ES_30: version = "#version 300 es\nprecision mediump float;\n"; break;
+        default: return 0;
+    }
+
+    char vertexSource[2048];
+    char fragmentSource[2048];
+    snprintf(vertexSource, sizeof(vertexSource), "%s%s%s", version, defines, vertexCode);
+    snprintf(fragmentSource, sizeof(fragmentSource), "%s%s%s", version, defines, fragmentCode);
+
+    // rlgl hands back its default shader when ours doesn't compile
+    unsigned int shader = rlLoadShaderCode(vertexSource, fragmentSource);
+    if (shader == 0 || shader == rlGetShaderIdDefault())
+    {
+        TraceLog(LOG_WARNING, "RENDER: Instancing shader failed to load");
+        return 0;
+    }
+
+    return shader;
+}
+
+void DrawRockImmediate(const RockInstance *rock)
+{
+    const Vector2 *outline = &render.rockShapes[(unsigned int)rock->shape*ROCK_SHAPE_VERTICES];
+    Vector2 position = rock->position;
+    float c = cosf(rock->rotation)*rock->radius;
+    float s = sinf(rock->rotation)*rock->radius;
+
+    // Flush first if the rock doesn't fit, so it's never split across batches
+    rlCheckRenderBatchLimit(ROCK_SHAPE_VERTICES*3);
+
+    // Triangle fan around the center, in the same winding as DrawCircleV
+    rlBegin(RL_TRIANGLES);
+    rlColor4ub(rock->color.r, rock->color.g, rock->color.b, rock->color.a);
+    for (unsigned int i = 0; i < ROCK_SHAPE_VERTICES; i++)
+    {
+        Vector2 corner = outline[i];
+        Vector2 next = outline[(i + 1)%ROCK_SHAPE_VERTICES];
+
+        rlVertex2f(position.x, position.y);
+        rlVertex2f(position.x + next.x*c - next.y*s, position.y + next.x*s + next.y*c);
+        rlVertex2f(position.x + corner.x*c - corner.y*s, position.y + corner.x*s + corner.y*c);
+    }
+    rlEnd();
+}
+
+float GetShapeNoise(unsigned int seed)
+{
+    // lowbias32 integer hash
+    seed ^= seed >> 16;
+    seed *= 0x7feb352du;
+    seed ^= seed >> 15;
+    seed *= 0x846ca68bu;
+    seed ^= seed >> 16;
+
+    return (seed >> 8)*(1.0f/16777216.0f);
+}
@@ -0,0 +1,103 @@
+// EXPLANATION:
+// Drawing resources that are built once and reused every frame
+// - The star field is static, so it's drawn into a texture at the
+//   viewport's resolution and the texture is drawn instead of every star
+// - Rocks are jagged polygons picked from a small library of outlines made
+//   at startup. They're queued as instances (shape, position, radius,
+//   rotation, color) and drawn together from one shared triangle fan, the
+//   vertex shader looks up each corner in the outline library
+// - Missiles and explosion flashes are queued as circle instances (center,
+//   radius, color) and drawn together: each instance is a quad and a
+//   signed-distance fragment shader cuts the circle out of it, with a smooth
+//   edge
+// - Instancing needs OpenGL 3.3 or ES 3.0. Anything older draws the queued
+//   rocks through raylib's vertex batch and the circles one by one with DrawCircleV
+
+#ifndef ASTEROIDS_RENDER_HEADER_GUARD
+#define ASTEROIDS_RENDER_HEADER_GUARD
+
+#include "raylib.h"
+#include "asteroids.h"
+
+// Macros
+// ----------------------------------------------------------------------------
+#define ROCK_SHAPE_VERTICES 12 // corners on a rock's outline
+#define ROCK_SHAPE_VARIANTS 4  // different outlines per rock size
+#define ROCK_SHAPE_COUNT (ROCK_SHAPE_VARIANTS*3)
+#define ROCK_BATCH_SIZE 4096   // rocks per instanced draw call
+#define CIRCLE_BATCH_SIZE 4096 // circles per instanced draw call
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+
+// One rock of the instance buffer, 24 bytes
+typedef struct RockInstance {
+    Vector2 position;
+    float radius;
+    float rotation; // in radians
+    float shape;    // index into rockShapes, a float like the rest of the attributes
+    Color color;
+} RockInstance;
+
+// One circle of the instance buffer, 16 bytes
+typedef struct CircleInstance {
+    Vector2 center;
+    float radius;
+    Color color;
+} CircleInstance;
+
+typedef struct RenderCache {
+    RenderTexture2D starField; // game.stars, in viewport pixels
+    bool isStarFieldBaked;
+
+    // Outline of every rock shape, farthest corner at 1. Shape s is at
+    // rockShapes[s*ROCK_SHAPE_VERTICES] up to the next shape
+    Vector2 rockShapes[ROCK_SHAPE_COUNT*ROCK_SHAPE_VERTICES];
+
+    // Rocks queued since the last DrawRockBatch()
+    RockInstance rocks[ROCK_BATCH_SIZE];
+    unsigned int rockCount;
+
+    // GPU side of the rocks, all 0 without instancing
+    unsigned int rockShader; // holds rockShapes in a uniform
+    int rockMvpLocation;
+    unsigned int rockVao;
+    unsigned int rockFanVbo;      // corner index of each vertex of the triangle fan, -1 for the center
+    unsigned int rockInstanceVbo; // a copy of rocks
+    bool isRockInstanced; // false draws them through raylib's vertex batch
+
+    // Circles queued since the last DrawCircleBatch()
+    CircleInstance circles[CIRCLE_BATCH_SIZE];
+    unsigned int circleCount;
+
+    // GPU side of the circles, all 0 without instancing
+    unsigned int circleShader;
+    int circleMvpLocation;
+    unsigned int circleVao;
+    unsigned int circleQuadVbo;     // the 6 corners of a quad around the unit circle
+    unsigned int circleInstanceVbo; // a copy of circles
+    bool isCircleInstanced; // false draws them with DrawCircleV
+} RenderCache;
+
+extern RenderCache render; // global declaration
+
+// Prototypes
+// ----------------------------------------------------------------------------
+
+// Initialize
+void InitRenderCache(void); // Generate the rock shapes, load the rock and circle shaders and buffers
+void FreeRenderCache(void); // Unload every cached GPU resource
+
+// Update
+void BakeStarField(int width, int height); // Redraw the stars into a width x height texture, if that size changed
+void RebakeStarField(void); // Redraw the stars into the texture at its size, after game.stars changed
+
+// Draw
+void DrawStarField(void); // Draw the baked stars over the whole game world
+unsigned int GetRockShape(SizeOfAsteroid size, unsigned int slot); // Same shape for as long as the rock lives
+void QueueRock(unsigned int shape, Vector2 position, float radius, float rotation, Color color); // rotation in degrees, drawn by the next DrawRockBatch()
+void DrawRockBatch(void); // Draw every queued rock in one draw call, over whatever was drawn before
+void QueueCircle(Vector2 center, float radius, Color color); // Drawn by the next DrawCircleBatch(), in the order queued
+void DrawCircleBatch(void); // Draw every queued circle in one draw call, over whatever was drawn before
+
+#endif // ASTEROIDS_RENDER_HEADER_GUARD
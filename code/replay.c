@@ -0,0 +1,243 @@
+// EXPLANATION:
+// Input recording and deterministic playback
+// See replay.h for more documentation/descriptions
+
+#include "replay.h"
+
+#include <stdio.h>
+#include <string.h> // for memcmp, memcpy
+
+#include "allocator.h"
+#include "config.h"
+
+#define REPLAY_MAX_RUN 0xffff // ticks a single run can repeat
+
+// Bits of the packed mouse flags byte
+#define REPLAY_MOUSE_MOVED 0x01
+#define REPLAY_MOUSE_LEFT_DOWN 0x02
+#define REPLAY_MOUSE_RIGHT_DOWN 0x04
+
+// Globals
+// ----------------------------------------------------------------------------
+ReplayLog replay = { 0 };
+
+// Local Functions Declaration
+// ----------------------------------------------------------------------------
+bool ReserveReplayTicks(unsigned int capacity);
+bool IsSameTickInput(const TickInput *a, const TickInput *b);
+void WriteU16(FILE *file, unsigned short value);
+void WriteU32(FILE *file, unsigned int value);
+bool ReadU16(FILE *file, unsigned short *value);
+bool ReadU32(FILE *file, unsigned int *value);
+
+void StartRecording(unsigned int seed, unsigned int expectedTicks)
+{
+    FreeReplay();
+    replay.mode = REPLAY_RECORDING;
+    replay.seed = seed;
+    ReserveReplayTicks((expectedTicks > 0)? expectedTicks : 60*SIM_TICK_RATE);
+}
+
+void RecordReplayTick(const TickInput *input)
+{
+    if (replay.mode != REPLAY_RECORDING) return;
+
+    if (replay.tickCount == replay.capacity && !ReserveReplayTicks(replay.capacity*2))
+    {
+        TraceLog(LOG_WARNING, "REPLAY: Out of memory, recording stopped at tick %u", replay.tickCount);
+        replay.mode = REPLAY_OFF;
+        return;
+    }
+
+    replay.ticks[replay.tickCount++] = *input;
+}
+
+bool SaveReplay(const char *path)
+{
+    FILE *file = fopen(path, "wb");
+    if (!file)
+    {
+        TraceLog(LOG_WARNING, "REPLAY: Could not write %s", path);
+        return false;
+    }
+
+    fwrite(REPLAY_MAGIC, 1, 4, file);
+    WriteU16(file, REPLAY_VERSION);
+    WriteU16(file, SIM_TICK_RATE);
+    WriteU32(file, replay.seed);
+    WriteU32(file, replay.tickCount);
+
+    // Held keys and a still mouse repeat the same input for long stretches
+    for (unsigned int i = 0; i < replay.tickCount; )
+    {
+        const TickInput *input = &replay.ticks[i];
+        unsigned int run = 1;
+        while (run < REPLAY_MAX_RUN && i + run < replay.tickCount && IsSameTickInput(input, &replay.ticks[i + run]))
+            run++;
+
+        unsigned int mouseX, mouseY;
+        memcpy(&mouseX, &input->mousePosition.x, sizeof(mouseX));
+        memcpy(&mouseY, &input->mousePosition.y, sizeof(mouseY));
+        unsigned char mouseFlags = (input->mouseMoved? REPLAY_MOUSE_MOVED : 0) |
+                                   (input->mouseLeftDown? REPLAY_MOUSE_LEFT_DOWN : 0) |
+                                   (input->mouseRightDown? REPLAY_MOUSE_RIGHT_DOWN : 0);
+
+        WriteU16(file, (unsigned short)run);
+        WriteU32(file, input->actionsDown);
+        WriteU32(file, input->actionsPressed);
+        WriteU32(file, mouseX);
+        WriteU32(file, mouseY);
+        fputc(mouseFlags, file);
+
+        i += run;
+    }
+
+    bool success = !ferror(file);
+    if (fclose(file) != 0) success = false;
+
+    if (success)
+        TraceLog(LOG_INFO, "REPLAY: Saved %u ticks to %s", replay.tickCount, path);
+    else
+        TraceLog(LOG_WARNING, "REPLAY: Failed writing %s", path);
+    return success;
+}
+
+bool LoadReplay(const char *path)
+{
+    FreeReplay();
+
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        TraceLog(LOG_WARNING, "REPLAY: Could not open %s", path);
+        return false;
+    }
+
+    ReplayHeader header = { 0 };
+    bool valid = fread(header.magic, 1, 4, file) == 4 && memcmp(header.magic, REPLAY_MAGIC, 4) == 0 &&
+                 ReadU16(file, &header.version) && header.version == REPLAY_VERSION &&
+                 ReadU16(file, &header.tickRate) &&
+                 ReadU32(file, &header.seed) &&
+                 ReadU32(file, &header.tickCount);
+    if (!valid)
+    {
+        TraceLog(LOG_WARNING, "REPLAY: %s is not a version %d replay", path, REPLAY_VERSION);
+        fclose(file);
+        return false;
+    }
+    if (header.tickRate != SIM_TICK_RATE)
+        TraceLog(LOG_WARNING, "REPLAY: %s was recorded at %d ticks per second, not %d, it won't play back exactly",
+                 path, header.tickRate, SIM_TICK_RATE);
+
+    if (!ReserveReplayTicks((header.tickCount > 0)? header.tickCount : 1))
+    {
+        TraceLog(LOG_WARNING, "REPLAY: Out of memory loading %s", path);
+        fclose(file);
+        return false;
+    }
+
+    while (replay.tickCount < header.tickCount)
+    {
+        unsigned short run;
+        unsigned int mouseX, mouseY;
+        TickInput input = { 0 };
+        if (!ReadU16(file, &run) || run == 0 || run > header.tickCount - replay.tickCount ||
+            !ReadU32(file, &input.actionsDown) || !ReadU32(file, &input.actionsPressed) ||
+            !ReadU32(file, &mouseX) || !ReadU32(file, &mouseY))
+            break;
+        int mouseFlags = fgetc(file);
+        if (mouseFlags == EOF) break;
+
+        memcpy(&input.mousePosition.x, &mouseX, sizeof(mouseX));
+        memcpy(&input.mousePosition.y, &mouseY, sizeof(mouseY));
+        input.mouseMoved = (mouseFlags & REPLAY_MOUSE_MOVED) != 0;
+        input.mouseLeftDown = (mouseFlags & REPLAY_MOUSE_LEFT_DOWN) != 0;
+        input.mouseRightDown = (mouseFlags & REPLAY_MOUSE_RIGHT_DOWN) != 0;
+
+        for (unsigned int i = 0; i < run; i++)
+            replay.ticks[replay.tickCount++] = input;
+    }
+    fclose(file);
+
+    if (replay.tickCount != header.tickCount)
+    {
+        TraceLog(LOG_WARNING, "REPLAY: %s is truncated, %u of %u ticks read", path, replay.tickCount, header.tickCount);
+        FreeReplay();
+        return false;
+    }
+
+    replay.mode = REPLAY_PLAYING;
+    replay.seed = header.seed;
+    replay.cursor = 0;
+    TraceLog(LOG_INFO, "REPLAY: Loaded %u ticks from %s (seed %u)", replay.tickCount, path, replay.seed);
+    return true;
+}
+
+bool PlayReplayTick(TickInput *input)
+{
+    if (replay.mode != REPLAY_PLAYING || replay.cursor >= replay.tickCount)
+        return false;
+
+    *input = replay.ticks[replay.cursor++];
+    return true;
+}
+
+void FreeReplay(void)
+{
+    GameFree(replay.ticks);
+    replay = (ReplayLog){ 0 };
+}
+
+bool ReserveReplayTicks(unsigned int capacity)
+{
+    if (capacity <= replay.capacity) return true;
+
+    TickInput *ticks = GameRealloc(replay.ticks, capacity*sizeof(TickInput));
+    if (!ticks) return false;
+
+    replay.ticks = ticks;
+    replay.capacity = capacity;
+    return true;
+}
+
+bool IsSameTickInput(const TickInput *a, const TickInput *b)
+{
+    return a->actionsDown == b->actionsDown &&
+           a->actionsPressed == b->actionsPressed &&
+           a->mousePosition.x == b->mousePosition.x &&
+           a->mousePosition.y == b->mousePosition.y &&
+           a->mouseMoved == b->mouseMoved &&
+           a->mouseLeftDown == b->mouseLeftDown &&
+           a->mouseRightDown == b->mouseRightDown;
+}
+
+void WriteU16(FILE *file, unsigned short value)
+{
+    fputc(value & 0xff, file);
+    fputc((value >> 8) & 0xff, file);
+}
+
+void WriteU32(FILE *file, unsigned int value)
+{
+    WriteU16(file, (unsigned short)(value & 0xffff));
+    WriteU16(file, (unsigned short)(value >> 16));
+}
+
+bool ReadU16(FILE *file, unsigned short *value)
+{
+    int low = fgetc(file);
+    int high = fgetc(file);
+    if (low == EOF || high == EOF) return false;
+
+    *value = (unsigned short)(low | (high << 8));
+    return true;
+}
+
+bool ReadU32(FILE *file, unsigned int *value)
+{
+    unsigned short low, high;
+    if (!ReadU16(file, &low) || !ReadU16(file, &high)) return false;
+
+    *value = low | ((unsigned int)high << 16);
+    return true;
+}
@@ -0,0 +1,58 @@
+// EXPLANATION:
+// Records the input of a game session and plays it back tick for tick
+// - A session is its RNG seed plus the TickInput each simulation tick saw,
+//   so feeding the same input through UpdateGameTick() reproduces it exactly
+// - Recorded with --record [file] in the game or the headless build,
+//   played back with --replay file in the game, headless build and benchmarks
+// - File format (little-endian): ReplayHeader, then runs of identical ticks,
+//   each a 2 byte repeat count followed by one packed tick (17 bytes)
+
+#ifndef ASTEROIDS_REPLAY_HEADER_GUARD
+#define ASTEROIDS_REPLAY_HEADER_GUARD
+
+#include "input.h"
+
+// Macros
+// ----------------------------------------------------------------------------
+#define REPLAY_DEFAULT_PATH "session.replay"
+#define REPLAY_MAGIC "ASRP"
+#define REPLAY_VERSION 3 // 2: game.random replaced raylib's GetRandomValue(), 3: missiles swept against rocks
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+
+typedef enum ReplayMode {
+    REPLAY_OFF,
+    REPLAY_RECORDING,
+    REPLAY_PLAYING,
+} ReplayMode;
+
+typedef struct ReplayHeader {
+    char magic[4];          // REPLAY_MAGIC
+    unsigned short version; // REPLAY_VERSION
+    unsigned short tickRate; // SIM_TICK_RATE of the recording, a replay is only exact at the same rate
+    unsigned int seed;      // what the session's InitGameState() was given
+    unsigned int tickCount;
+} ReplayHeader;
+
+typedef struct ReplayLog {
+    ReplayMode mode;
+    unsigned int seed;
+    TickInput *ticks; // unpacked, one per tick
+    unsigned int tickCount;
+    unsigned int capacity;
+    unsigned int cursor; // next tick to play back
+} ReplayLog;
+
+extern ReplayLog replay; // global declaration
+
+// Prototypes
+// ----------------------------------------------------------------------------
+void StartRecording(unsigned int seed, unsigned int expectedTicks); // Reserves room so recording doesn't allocate every tick
+void RecordReplayTick(const TickInput *input); // Call with the input each tick is about to run with
+bool SaveReplay(const char *path);
+bool LoadReplay(const char *path); // Starts playback from the first tick
+bool PlayReplayTick(TickInput *input); // Overwrites the input with the next recorded tick, false once all have played
+void FreeReplay(void);
+
+#endif // ASTEROIDS_REPLAY_HEADER_GUARD
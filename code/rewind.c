@@ -0,0 +1,315 @@
+// EXPLANATION:
+// Rewind history of the game simulation
+// See rewind.h for more documentation/descriptions
+
+#include "rewind.h"
+
+#include <string.h> // for memcpy
+
+#include "allocator.h"
+#include "asteroids.h"
+
+// Globals
+// ----------------------------------------------------------------------------
+RewindBuffer rewindBuffer = { 0 };
+
+// Local Functions Declaration
+// ----------------------------------------------------------------------------
+bool FindRewindSpace(unsigned int size, unsigned int *offset); // Free bytes after the newest tick, false if there aren't enough
+void DropOldestRewindKeyframe(void); // Along with the deltas against it
+unsigned int EncodeRewindDelta(const unsigned char *snapshot, const unsigned char *key, unsigned int limit); // Into the delta scratch, in words, 0 if over the limit
+bool EncodeRewindPart(const unsigned int *words, unsigned int count, const unsigned int *key, unsigned int keyCount,
+                      unsigned int *size, unsigned int limit);
+const unsigned int *DecodeRewindPart(const unsigned int *delta, unsigned int *words, unsigned int count,
+                                     const unsigned int *key, unsigned int keyCount); // Returns the delta after it
+bool DecodeRewindTick(unsigned int number); // Into the current snapshot
+
+void InitRewindBuffer(void)
+{
+    RewindBuffer *rewind = &rewindBuffer;
+    *rewind = (RewindBuffer){ 0 };
+
+    // The pools' capacities are fixed, so the scratch never has to grow while playing
+    unsigned int scratchSize = GetSnapshotMaxSize();
+    rewind->data = GameAlloc(REWIND_BUDGET);
+    rewind->current.data = GameAlloc(scratchSize);
+    rewind->delta = GameAlloc(scratchSize);
+    if (!rewind->data || !rewind->current.data || !rewind->delta)
+    {
+        TraceLog(LOG_WARNING, "REWIND: Couldn't allocate the history, rewind is off");
+        FreeRewindBuffer();
+        return;
+    }
+    rewind->current.capacity = scratchSize;
+}
+
+void RecordRewindTick(void)
+{
+    RewindBuffer *rewind = &rewindBuffer;
+    rewind->isRewinding = false;
+    if (!rewind->data) return;
+
+    unsigned int size = GetSnapshotSize(); // whole words, at most the scratch's size
+    unsigned int words = size/4;
+    if (!SaveSnapshot(&rewind->current)) return;
+
+    // Against the newest tick's keyframe, unless that one is due for a new keyframe
+    unsigned int number = rewind->oldest + rewind->count;
+    unsigned int keyframe = number;
+    unsigned int storedWords = 0;
+    unsigned int groupBytes = 0; // of the newest tick's keyframe and its deltas
+    if (rewind->count > 0)
+    {
+        RewindTick *newest = &rewind->ticks[(number - 1)%REWIND_MAX_TICKS];
+        RewindTick *key = &rewind->ticks[newest->keyframe%REWIND_MAX_TICKS];
+        groupBytes = newest->groupBytes;
+
+        // Smaller groups so dropping the oldest one never loses much of the history
+        if (number - newest->keyframe < REWIND_KEYFRAME_INTERVAL && groupBytes < REWIND_BUDGET/4)
+        {
+            unsigned int limit = (unsigned int)(words*REWIND_MAX_DELTA_RATIO);
+            storedWords = EncodeRewindDelta(rewind->current.data, rewind->data + key->offset, limit);
+            if (storedWords > 0) keyframe = newest->keyframe;
+        }
+    }
+    if (keyframe == number) storedWords = words;
+
+    unsigned int bytes = storedWords*4;
+    if (bytes > REWIND_BUDGET)
+    {
+        // Doesn't fit even on its own, and the next delta would need it
+        ClearRewindBuffer();
+        rewind->droppedCount++;
+        return;
+    }
+
+    // Make room, dropping whole keyframes with their deltas from the oldest end
+    unsigned int offset = 0;
+    while (rewind->count == REWIND_MAX_TICKS || !FindRewindSpace(bytes, &offset))
+    {
+        if (keyframe != number && keyframe == rewind->oldest)
+        {
+            // The keyframe this delta is against has to go, store a keyframe instead
+            keyframe = number;
+            storedWords = words;
+            bytes = storedWords*4;
+            continue;
+        }
+        DropOldestRewindKeyframe();
+    }
+
+    const unsigned int *source = (keyframe == number)? (unsigned int *)rewind->current.data : rewind->delta;
+    memcpy(rewind->data + offset, source, bytes);
+
+    rewind->ticks[number%REWIND_MAX_TICKS] = (RewindTick){
+        .offset = offset,
+        .size = bytes,
+        .snapshotSize = size,
+        .keyframe = keyframe,
+        .groupBytes = (keyframe == number)? bytes : groupBytes + bytes,
+    };
+    if (rewind->count == 0) rewind->oldest = number;
+    rewind->count++;
+    rewind->bytesUsed += bytes;
+}
+
+bool StepRewind(void)
+{
+    RewindBuffer *rewind = &rewindBuffer;
+    if (rewind->count < 2) return false;
+
+    rewind->count--;
+    rewind->bytesUsed -= rewind->ticks[(rewind->oldest + rewind->count)%REWIND_MAX_TICKS].size;
+
+    // The live input keeps track of what's held right now, not back then
+    TickInput input = game.input;
+    if (!DecodeRewindTick(rewind->oldest + rewind->count - 1) || !RestoreSnapshot(&rewind->current))
+    {
+        ClearRewindBuffer();
+        return false;
+    }
+    game.input = input;
+
+    rewind->isRewinding = true;
+    return true;
+}
+
+void ClearRewindBuffer(void)
+{
+    rewindBuffer.oldest = 0;
+    rewindBuffer.count = 0;
+    rewindBuffer.bytesUsed = 0;
+    rewindBuffer.isRewinding = false;
+}
+
+void FreeRewindBuffer(void)
+{
+    GameFree(rewindBuffer.data);
+    GameFree(rewindBuffer.delta);
+    FreeSnapshot(&rewindBuffer.current);
+    rewindBuffer = (RewindBuffer){ 0 };
+}
+
+float GetRewindSeconds(void)
+{
+    return (float)rewindBuffer.count/SIM_TICK_RATE;
+}
+
+float GetRewindBytesPerSecond(void)
+{
+    if (rewindBuffer.count == 0) return 0.0f;
+    return rewindBuffer.bytesUsed/GetRewindSeconds();
+}
+
+bool FindRewindSpace(unsigned int size, unsigned int *offset)
+{
+    RewindBuffer *rewind = &rewindBuffer;
+    if (rewind->count == 0)
+    {
+        *offset = 0;
+        return size <= REWIND_BUDGET;
+    }
+
+    RewindTick *oldest = &rewind->ticks[rewind->oldest%REWIND_MAX_TICKS];
+    RewindTick *newest = &rewind->ticks[(rewind->oldest + rewind->count - 1)%REWIND_MAX_TICKS];
+    unsigned int tail = oldest->offset;
+    unsigned int head = newest->offset + newest->size;
+
+    if (head > tail)
+    {
+        // Free space at the end, then at the start before the oldest tick
+        if (REWIND_BUDGET - head >= size) *offset = head;
+        else if (tail >= size) *offset = 0;
+        else return false;
+    }
+    else
+    {
+        // Wrapped around, free space is only between the newest and oldest ticks
+        if (tail - head >= size) *offset = head;
+        else return false;
+    }
+    return true;
+}
+
+void DropOldestRewindKeyframe(void)
+{
+    RewindBuffer *rewind = &rewindBuffer;
+    do
+    {
+        rewind->bytesUsed -= rewind->ticks[rewind->oldest%REWIND_MAX_TICKS].size;
+        rewind->oldest++;
+        rewind->count--;
+    } while (rewind->count > 0 && rewind->ticks[rewind->oldest%REWIND_MAX_TICKS].keyframe != rewind->oldest);
+}
+
+// A delta is made of the snapshot's parts in order, each compared against
+// the same part of the keyframe. A part is a list of runs, each one word
+// holding the count of unchanged words (high 16 bits) and of changed words
+// (low 16 bits), followed by the changed words XORed with the keyframe's.
+// Where the keyframe's part is shorter the rest is XORed with zeroes
+unsigned int EncodeRewindDelta(const unsigned char *snapshot, const unsigned char *key, unsigned int limit)
+{
+    SnapshotHeader header, keyHeader;
+    memcpy(&header, snapshot, sizeof(header));
+    memcpy(&keyHeader, key, sizeof(keyHeader));
+    unsigned int sizes[SNAPSHOT_PART_COUNT], keySizes[SNAPSHOT_PART_COUNT];
+    GetSnapshotPartSizes(&header, sizes);
+    GetSnapshotPartSizes(&keyHeader, keySizes);
+
+    unsigned int size = 0;
+    for (unsigned int p = 0; p < SNAPSHOT_PART_COUNT; p++)
+    {
+        if (!EncodeRewindPart((const unsigned int *)snapshot, sizes[p]/4,
+                              (const unsigned int *)key, keySizes[p]/4, &size, limit))
+            return 0;
+        snapshot += sizes[p];
+        key += keySizes[p];
+    }
+
+    return size;
+}
+
+bool EncodeRewindPart(const unsigned int *words, unsigned int count, const unsigned int *key, unsigned int keyCount,
+                      unsigned int *size, unsigned int limit)
+{
+    unsigned int *delta = rewindBuffer.delta;
+    unsigned int i = 0;
+    while (i < count)
+    {
+        unsigned int same = 0;
+        while (i < count && same < REWIND_MAX_RUN && words[i] == ((i < keyCount)? key[i] : 0))
+        {
+            same++;
+            i++;
+        }
+
+        if (*size == limit) return false;
+        unsigned int run = (*size)++;
+        unsigned int changed = 0;
+        while (i < count && changed < REWIND_MAX_RUN)
+        {
+            unsigned int bits = words[i] ^ ((i < keyCount)? key[i] : 0);
+            if (bits == 0) break;
+            if (*size == limit) return false;
+            delta[(*size)++] = bits;
+            changed++;
+            i++;
+        }
+
+        delta[run] = (same << 16) | changed;
+    }
+
+    return true;
+}
+
+bool DecodeRewindTick(unsigned int number)
+{
+    RewindBuffer *rewind = &rewindBuffer;
+    RewindTick *tick = &rewind->ticks[number%REWIND_MAX_TICKS];
+    if (tick->snapshotSize > rewind->current.capacity) return false;
+    rewind->current.size = tick->snapshotSize;
+
+    if (tick->keyframe == number)
+    {
+        memcpy(rewind->current.data, rewind->data + tick->offset, tick->snapshotSize);
+        return true;
+    }
+
+    const unsigned char *key = rewind->data + rewind->ticks[tick->keyframe%REWIND_MAX_TICKS].offset;
+    const unsigned int *delta = (const unsigned int *)(rewind->data + tick->offset);
+    unsigned char *output = rewind->current.data;
+
+    // The header comes first, the size of every other part depends on it
+    SnapshotHeader header, keyHeader;
+    unsigned int sizes[SNAPSHOT_PART_COUNT], keySizes[SNAPSHOT_PART_COUNT];
+    memcpy(&keyHeader, key, sizeof(keyHeader));
+    GetSnapshotPartSizes(&keyHeader, keySizes);
+    delta = DecodeRewindPart(delta, (unsigned int *)output, keySizes[0]/4, (const unsigned int *)key, keySizes[0]/4);
+    memcpy(&header, output, sizeof(header));
+    GetSnapshotPartSizes(&header, sizes);
+
+    for (unsigned int p = 1; p < SNAPSHOT_PART_COUNT; p++)
+    {
+        output += sizes[p - 1];
+        key += keySizes[p - 1];
+        delta = DecodeRewindPart(delta, (unsigned int *)output, sizes[p]/4, (const unsigned int *)key, keySizes[p]/4);
+    }
+
+    return true;
+}
+
+const unsigned int *DecodeRewindPart(const unsigned int *delta, unsigned int *words, unsigned int count,
+                                     const unsigned int *key, unsigned int keyCount)
+{
+    unsigned int i = 0;
+    while (i < count)
+    {
+        unsigned int run = *delta++;
+        for (unsigned int same = run >> 16; same > 0; same--, i++)
+            words[i] = (i < keyCount)? key[i] : 0;
+        for (unsigned int changed = run & 0xffff; changed > 0; changed--, i++)
+            words[i] = *delta++ ^ ((i < keyCount)? key[i] : 0);
+    }
+
+    return delta;
+}
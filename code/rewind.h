@@ -0,0 +1,70 @@
+// EXPLANATION:
+// Rewind history of the game simulation (hold INPUT_ACTION_REWIND to scrub back)
+// - Every tick's snapshot (see snapshot.h) goes into one ring buffer of
+//   REWIND_BUDGET bytes, the oldest ticks are dropped to make room
+// - A keyframe is a whole snapshot, stored every REWIND_KEYFRAME_INTERVAL
+//   ticks. The ticks in between are stored as their XOR against the last
+//   keyframe, part by part, with runs of unchanged words left out
+// - Anything that doesn't move between keyframes (velocities, colors, sizes,
+//   handles) XORs to zero, so a delta costs roughly the rocks' positions.
+//   Comparing part by part keeps a rock being destroyed from shifting every
+//   array after the first one out of line with the keyframe's
+// - Ticks are popped off the newest end while rewinding, the game carries on
+//   from whichever tick the key was let go at
+
+#ifndef ASTEROIDS_REWIND_HEADER_GUARD
+#define ASTEROIDS_REWIND_HEADER_GUARD
+
+#include <stdbool.h>
+
+#include "config.h"
+#include "snapshot.h"
+
+// Macros
+// ----------------------------------------------------------------------------
+#define REWIND_BUDGET (16*1024*1024) // bytes of history, not counting the scratch snapshots
+#define REWIND_SECONDS 10 // most history kept when the budget allows it
+#define REWIND_MAX_TICKS (REWIND_SECONDS*SIM_TICK_RATE)
+#define REWIND_KEYFRAME_INTERVAL 60 // ticks between whole snapshots
+#define REWIND_MAX_DELTA_RATIO 0.75f // deltas bigger than this fraction of their snapshot become keyframes
+#define REWIND_MAX_RUN 0xffff // words in one run of a delta
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+
+// One stored tick, ticks are numbered from the start of the history
+typedef struct RewindTick {
+    unsigned int offset;   // into the ring buffer
+    unsigned int size;     // bytes stored, a multiple of 4
+    unsigned int snapshotSize; // bytes of the snapshot it decodes to
+    unsigned int keyframe; // number of the keyframe a delta is against, its own number for keyframes
+    unsigned int groupBytes; // stored bytes of its keyframe and the deltas up to this tick
+} RewindTick;
+
+typedef struct RewindBuffer {
+    unsigned char *data; // REWIND_BUDGET bytes, ticks are never split across its end
+    RewindTick ticks[REWIND_MAX_TICKS]; // ring, tick n is at ticks[n%REWIND_MAX_TICKS]
+    unsigned int oldest; // number of the oldest tick kept, always a keyframe
+    unsigned int count;  // ticks kept
+    unsigned int bytesUsed; // stored bytes of the ticks kept
+
+    Snapshot current; // scratch for the tick being recorded or restored, sized for full pools
+    unsigned int *delta; // scratch for encoding a delta, as big as current
+
+    bool isRewinding; // a tick was restored this frame
+    unsigned long long droppedCount; // ticks that didn't fit the budget on their own
+} RewindBuffer;
+
+extern RewindBuffer rewindBuffer; // global declaration
+
+// Prototypes
+// ----------------------------------------------------------------------------
+void InitRewindBuffer(void); // Allocates the budget and scratch up front, after InitGameState()
+void RecordRewindTick(void); // After each simulated tick
+bool StepRewind(void); // Drops the newest tick and restores the one before it, false once there is none
+void ClearRewindBuffer(void); // Forget the history, e.g. for a new game
+void FreeRewindBuffer(void);
+float GetRewindSeconds(void); // History held, in seconds of game time
+float GetRewindBytesPerSecond(void); // Stored bytes per second of history held
+
+#endif // ASTEROIDS_REWIND_HEADER_GUARD
@@ -0,0 +1,222 @@
+// EXPLANATION:
+// Snapshots of the game simulation
+// See snapshot.h for more documentation/descriptions
+
+#include "snapshot.h"
+
+#include <string.h> // for memcpy, memset
+
+#include "allocator.h"
+#include "asteroids.h"
+
+// Everything in GameState a snapshot keeps besides the pools
+typedef struct SnapshotGameFields {
+    SpaceShip ship;
+    TickInput input;
+    RandomStream random[RANDOM_STREAM_COUNT];
+    unsigned int seed;
+    unsigned int eliminatedCount;
+    unsigned int rockPeakCount;
+    unsigned int rockReuseCount;
+    unsigned int missileNextShot;
+} SnapshotGameFields;
+
+// Where a part of the snapshot comes from or goes to
+typedef struct SnapshotPart {
+    void *data;
+    unsigned int size; // unpadded
+} SnapshotPart;
+
+// Local Functions Declaration
+// ----------------------------------------------------------------------------
+SnapshotHeader GetGameSnapshotHeader(unsigned int size); // Of the game as it is now
+void GetSnapshotParts(SnapshotHeader *header, SnapshotGameFields *fields, SnapshotPart parts[SNAPSHOT_PART_COUNT]); // Sized for the header's counts
+
+unsigned int GetSnapshotSize(void)
+{
+    SnapshotHeader header = GetGameSnapshotHeader(0);
+    unsigned int sizes[SNAPSHOT_PART_COUNT];
+    GetSnapshotPartSizes(&header, sizes);
+
+    unsigned int size = 0;
+    for (unsigned int p = 0; p < SNAPSHOT_PART_COUNT; p++)
+        size += sizes[p];
+    return size;
+}
+
+unsigned int GetSnapshotMaxSize(void)
+{
+    // The pools never grow, so their capacities bound every count
+    SnapshotHeader header = GetGameSnapshotHeader(0);
+    header.rockCount = game.rocks.capacity;
+    header.rockSlotsUsed = game.rocks.capacity;
+    header.rockFreeCount = game.rocks.capacity;
+    header.missileLiveCount = game.missiles.capacity;
+    unsigned int sizes[SNAPSHOT_PART_COUNT];
+    GetSnapshotPartSizes(&header, sizes);
+
+    unsigned int size = 0;
+    for (unsigned int p = 0; p < SNAPSHOT_PART_COUNT; p++)
+        size += sizes[p];
+    return size;
+}
+
+void GetSnapshotPartSizes(const SnapshotHeader *header, unsigned int sizes[SNAPSHOT_PART_COUNT])
+{
+    SnapshotHeader copy = *header;
+    SnapshotGameFields fields;
+    SnapshotPart parts[SNAPSHOT_PART_COUNT];
+    GetSnapshotParts(&copy, &fields, parts);
+
+    for (unsigned int p = 0; p < SNAPSHOT_PART_COUNT; p++)
+        sizes[p] = SNAPSHOT_PAD(parts[p].size);
+}
+
+bool SaveSnapshot(Snapshot *snapshot)
+{
+    AsteroidPool *rocks = &game.rocks;
+    MissilePool *missiles = &game.missiles;
+
+    unsigned int size = GetSnapshotSize();
+    if (size > snapshot->capacity)
+    {
+        unsigned char *data = GameRealloc(snapshot->data, size);
+        if (!data) return false;
+        snapshot->data = data;
+        snapshot->capacity = size;
+    }
+
+    SnapshotHeader header = GetGameSnapshotHeader(size);
+    SnapshotGameFields fields = {
+        .ship = game.ship,
+        .input = game.input,
+        .seed = game.seed,
+        .eliminatedCount = game.eliminatedCount,
+        .rockPeakCount = rocks->peakCount,
+        .rockReuseCount = rocks->reuseCount,
+        .missileNextShot = missiles->nextShot,
+    };
+    memcpy(fields.random, game.random, sizeof(fields.random));
+
+    SnapshotPart parts[SNAPSHOT_PART_COUNT];
+    GetSnapshotParts(&header, &fields, parts);
+
+    unsigned char *cursor = snapshot->data;
+    for (unsigned int p = 0; p < SNAPSHOT_PART_COUNT; p++)
+    {
+        unsigned int padded = SNAPSHOT_PAD(parts[p].size);
+        memcpy(cursor, parts[p].data, parts[p].size);
+        memset(cursor + parts[p].size, 0, padded - parts[p].size);
+        cursor += padded;
+    }
+
+    snapshot->size = (unsigned int)(cursor - snapshot->data);
+    return true;
+}
+
+bool RestoreSnapshot(const Snapshot *snapshot)
+{
+    AsteroidPool *rocks = &game.rocks;
+    MissilePool *missiles = &game.missiles;
+
+    SnapshotHeader header;
+    if (snapshot->size < sizeof(header)) return false;
+    memcpy(&header, snapshot->data, sizeof(header));
+
+    if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION ||
+        header.size != snapshot->size ||
+        header.rockSlotsUsed > rocks->capacity || header.rockCount > header.rockSlotsUsed ||
+        header.rockFreeCount > header.rockSlotsUsed ||
+        header.missileCapacity != missiles->capacity || header.missileLiveCount > missiles->capacity)
+    {
+        TraceLog(LOG_WARNING, "SNAPSHOT: Doesn't fit the game's pools, not restored");
+        return false;
+    }
+
+    // The header was validated above, read the rest straight into the pools
+    SnapshotGameFields fields;
+    SnapshotPart parts[SNAPSHOT_PART_COUNT];
+    GetSnapshotParts(&header, &fields, parts);
+
+    const unsigned char *cursor = snapshot->data + SNAPSHOT_PAD(sizeof(header));
+    for (unsigned int p = 1; p < SNAPSHOT_PART_COUNT; p++)
+    {
+        memcpy(parts[p].data, cursor, parts[p].size);
+        cursor += SNAPSHOT_PAD(parts[p].size);
+    }
+
+    game.ship = fields.ship;
+    game.input = fields.input;
+    memcpy(game.random, fields.random, sizeof(game.random));
+    game.seed = fields.seed;
+    game.eliminatedCount = fields.eliminatedCount;
+
+    rocks->count = header.rockCount;
+    rocks->slotsUsed = header.rockSlotsUsed;
+    rocks->freeCount = header.rockFreeCount;
+    rocks->peakCount = fields.rockPeakCount;
+    rocks->reuseCount = fields.rockReuseCount;
+
+    missiles->liveCount = header.missileLiveCount;
+    missiles->nextShot = fields.missileNextShot;
+
+    return true;
+}
+
+void FreeSnapshot(Snapshot *snapshot)
+{
+    GameFree(snapshot->data);
+    *snapshot = (Snapshot){ 0 };
+}
+
+SnapshotHeader GetGameSnapshotHeader(unsigned int size)
+{
+    return (SnapshotHeader){
+        .magic = SNAPSHOT_MAGIC,
+        .version = SNAPSHOT_VERSION,
+        .size = size,
+        .rockCount = game.rocks.count,
+        .rockSlotsUsed = game.rocks.slotsUsed,
+        .rockFreeCount = game.rocks.freeCount,
+        .missileCapacity = game.missiles.capacity,
+        .missileLiveCount = game.missiles.liveCount,
+    };
+}
+
+void GetSnapshotParts(SnapshotHeader *header, SnapshotGameFields *fields, SnapshotPart parts[SNAPSHOT_PART_COUNT])
+{
+    AsteroidPool *rocks = &game.rocks;
+    MissilePool *missiles = &game.missiles;
+    unsigned int count = header->rockCount;
+    unsigned int capacity = header->missileCapacity;
+    unsigned int p = 0;
+
+    parts[p++] = (SnapshotPart){ header, sizeof(*header) };
+    parts[p++] = (SnapshotPart){ fields, sizeof(*fields) };
+
+    // Live rocks only, the rest of the pool is garbage
+    parts[p++] = (SnapshotPart){ rocks->position, count*sizeof(Vector2) };
+    parts[p++] = (SnapshotPart){ rocks->velocity, count*sizeof(Vector2) };
+    parts[p++] = (SnapshotPart){ rocks->radius, count*sizeof(float) };
+    parts[p++] = (SnapshotPart){ rocks->flags, count*sizeof(unsigned char) };
+    parts[p++] = (SnapshotPart){ rocks->previousPosition, count*sizeof(Vector2) };
+    parts[p++] = (SnapshotPart){ rocks->color, count*sizeof(Color) };
+    parts[p++] = (SnapshotPart){ rocks->angle, count*sizeof(float) };
+    parts[p++] = (SnapshotPart){ rocks->size, count*sizeof(SizeOfAsteroid) };
+    parts[p++] = (SnapshotPart){ rocks->slot, count*sizeof(unsigned int) };
+
+    // Handle slots, so handles held across a restore stay valid (or stale)
+    parts[p++] = (SnapshotPart){ rocks->slotIndex, header->rockSlotsUsed*sizeof(unsigned int) };
+    parts[p++] = (SnapshotPart){ rocks->generation, header->rockSlotsUsed*sizeof(unsigned int) };
+    parts[p++] = (SnapshotPart){ rocks->freeSlots, header->rockFreeCount*sizeof(unsigned int) };
+
+    // Every missile slot, exploded ones are still drawn and reused in order
+    parts[p++] = (SnapshotPart){ missiles->position, capacity*sizeof(Vector2) };
+    parts[p++] = (SnapshotPart){ missiles->velocity, capacity*sizeof(Vector2) };
+    parts[p++] = (SnapshotPart){ missiles->radius, capacity*sizeof(float) };
+    parts[p++] = (SnapshotPart){ missiles->flags, capacity*sizeof(unsigned char) };
+    parts[p++] = (SnapshotPart){ missiles->previousPosition, capacity*sizeof(Vector2) };
+    parts[p++] = (SnapshotPart){ missiles->despawnTimer, capacity*sizeof(float) };
+    parts[p++] = (SnapshotPart){ missiles->explosionTimer, capacity*sizeof(float) };
+    parts[p++] = (SnapshotPart){ missiles->liveIds, header->missileLiveCount*sizeof(unsigned int) };
+}
@@ -0,0 +1,54 @@
+// EXPLANATION:
+// Snapshots of the game simulation, for save states, rewind and rollback
+// - Everything a tick reads or writes: ship, missiles, live rocks, their
+//   handle slots, pending input, random streams and counters
+// - Written into one flat buffer of plain bytes with no pointers, so it can
+//   be copied, stored or sent anywhere and restored into the pools later
+// - Each part (header, game fields, one pool array) starts on a whole word,
+//   so parts of two snapshots can be compared word by word (see rewind.h)
+// - Not included: the collision grid (rebuilt every tick), the camera, stars
+//   and anything else that only matters for drawing
+
+#ifndef ASTEROIDS_SNAPSHOT_HEADER_GUARD
+#define ASTEROIDS_SNAPSHOT_HEADER_GUARD
+
+#include <stdbool.h>
+
+// Macros
+// ----------------------------------------------------------------------------
+#define SNAPSHOT_MAGIC 0x50534153u // "SASP"
+#define SNAPSHOT_VERSION 3 // 2: parts padded to whole words, 3: no screen edge state in the ship and flags
+#define SNAPSHOT_PART_COUNT 22 // header, game fields, 12 rock arrays and 8 missile arrays
+#define SNAPSHOT_PAD(size) (((size) + 3u) & ~3u)
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+
+// Start of every snapshot buffer, the arrays follow in a fixed order
+typedef struct SnapshotHeader {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int size; // whole snapshot in bytes, header included
+    unsigned int rockCount;
+    unsigned int rockSlotsUsed;
+    unsigned int rockFreeCount;
+    unsigned int missileCapacity;
+    unsigned int missileLiveCount;
+} SnapshotHeader;
+
+typedef struct Snapshot {
+    unsigned char *data;
+    unsigned int size;     // bytes in use
+    unsigned int capacity; // bytes allocated
+} Snapshot;
+
+// Prototypes
+// ----------------------------------------------------------------------------
+unsigned int GetSnapshotSize(void); // Bytes a snapshot of the current game takes
+unsigned int GetSnapshotMaxSize(void); // Bytes a snapshot takes with every pool full, for buffers sized once
+void GetSnapshotPartSizes(const SnapshotHeader *header, unsigned int sizes[SNAPSHOT_PART_COUNT]); // Padded, in the order they are stored
+bool SaveSnapshot(Snapshot *snapshot); // Only allocates when the game grew past the buffer
+bool RestoreSnapshot(const Snapshot *snapshot); // false, leaving the game untouched, if it doesn't fit the pools
+void FreeSnapshot(Snapshot *snapshot);
+
+#endif // ASTEROIDS_SNAPSHOT_HEADER_GUARD
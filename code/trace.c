@@ -0,0 +1,260 @@
+// EXPLANATION:
+// Chrome trace-event export of the profiler zones
+// See trace.h for more documentation/descriptions
+
+#if !defined(_WIN32)
+    #define _POSIX_C_SOURCE 200809L // for clock_gettime
+#endif
+
+#include "trace.h"
+
+#include "config.h"
+
+#if defined(TRACE_ENABLED)
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <time.h>
+#endif
+
+// raylib's logging, declared by hand since windows.h clashes with raylib.h
+#define TRACE_LOG_WARNING 4 // LOG_WARNING
+void TraceLog(int logLevel, const char *text, ...);
+
+// Globals
+// ----------------------------------------------------------------------------
+TraceState trace = { 0 };
+
+// Double buffered: the game thread fills one buffer while the writer thread
+// empties the other. Only FlushTrace swaps them, and only once the writer is done
+TraceEvent *recordEvents; // game thread
+unsigned int recordCount;
+TraceEvent *writeEvents;  // writer thread, while writeCount > 0
+unsigned int writeCount;
+
+FILE *traceFile;
+const char *const *traceNames;
+unsigned int traceNameCount;
+bool shouldStop;
+double startTime;
+
+#if defined(_WIN32)
+HANDLE writerThread;
+CRITICAL_SECTION writerLock;
+CONDITION_VARIABLE writerWake;
+long long timerFrequency;
+#else
+pthread_t writerThread;
+pthread_mutex_t writerLock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t writerWake = PTHREAD_COND_INITIALIZER;
+#endif
+
+// Local Functions Declaration
+// ----------------------------------------------------------------------------
+double GetTraceTime(void); // Microseconds, from a monotonic clock
+void WriteTraceEvents(const TraceEvent *events, unsigned int count);
+void LockWriter(void);
+void UnlockWriter(void);
+void WakeWriter(void);
+void WaitWriter(void); // Sleep until woken, with the lock held
+void AbortTrace(void); // Undo a StartTrace that failed partway, tracing stays off
+#if defined(_WIN32)
+DWORD WINAPI RunTraceWriter(LPVOID unused);
+#else
+void *RunTraceWriter(void *unused);
+#endif
+
+bool StartTrace(const char *path, const char *const *names, unsigned int nameCount)
+{
+    traceFile = fopen(path, "w");
+    if (!traceFile)
+    {
+        TraceLog(TRACE_LOG_WARNING, "TRACE: Could not open %s", path);
+        return false;
+    }
+
+    recordEvents = malloc(TRACE_BUFFER_EVENTS*sizeof(TraceEvent));
+    writeEvents = malloc(TRACE_BUFFER_EVENTS*sizeof(TraceEvent));
+    if (!recordEvents || !writeEvents)
+    {
+        TraceLog(TRACE_LOG_WARNING, "TRACE: Could not allocate the event buffers, not tracing");
+        AbortTrace();
+        return false;
+    }
+    recordCount = writeCount = 0;
+    traceNames = names;
+    traceNameCount = nameCount;
+    shouldStop = false;
+
+    // JSON array format, label the game thread
+    fprintf(traceFile, "[\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"Game\"}}");
+
+#if defined(_WIN32)
+    QueryPerformanceFrequency((LARGE_INTEGER *)&timerFrequency);
+    InitializeCriticalSection(&writerLock);
+    InitializeConditionVariable(&writerWake);
+    writerThread = CreateThread(NULL, 0, RunTraceWriter, NULL, 0, NULL);
+    bool isWriterRunning = (writerThread != NULL);
+    if (!isWriterRunning) DeleteCriticalSection(&writerLock);
+#else
+    bool isWriterRunning = (pthread_create(&writerThread, NULL, RunTraceWriter, NULL) == 0);
+#endif
+    if (!isWriterRunning)
+    {
+        TraceLog(TRACE_LOG_WARNING, "TRACE: Could not start the writer thread, not tracing");
+        AbortTrace();
+        return false;
+    }
+
+    startTime = GetTraceTime();
+    trace = (TraceState){ .isRecording = true };
+    printf("TRACE: Recording to %s\n", path);
+
+    return true;
+}
+
+void StopTrace(void)
+{
+    if (!trace.isRecording) return;
+    trace.isRecording = false;
+
+    LockWriter();
+    shouldStop = true;
+    WakeWriter();
+    UnlockWriter();
+
+#if defined(_WIN32)
+    WaitForSingleObject(writerThread, INFINITE);
+    CloseHandle(writerThread);
+    DeleteCriticalSection(&writerLock);
+#else
+    pthread_join(writerThread, NULL);
+#endif
+
+    // The writer is gone, write whatever was recorded since the last flush
+    WriteTraceEvents(recordEvents, recordCount);
+    fprintf(traceFile, "\n]\n");
+    fclose(traceFile);
+    free(recordEvents);
+    free(writeEvents);
+
+    if (trace.droppedCount > 0)
+        fprintf(stderr, "TRACE: %llu events dropped, the writer fell behind\n", trace.droppedCount);
+}
+
+void AbortTrace(void)
+{
+    fclose(traceFile);
+    free(recordEvents);
+    free(writeEvents);
+    traceFile = NULL;
+    recordEvents = writeEvents = NULL;
+    trace = (TraceState){ 0 };
+}
+
+void TraceZone(unsigned int name, TracePhase phase)
+{
+    if (!trace.isRecording) return;
+
+    if (recordCount == TRACE_BUFFER_EVENTS)
+    {
+        trace.droppedCount++;
+        return;
+    }
+
+    recordEvents[recordCount++] = (TraceEvent){
+        .timestamp = GetTraceTime() - startTime,
+        .name = (unsigned short)name,
+        .phase = (char)phase,
+    };
+}
+
+void FlushTrace(void)
+{
+    if (!trace.isRecording || recordCount == 0) return;
+
+    // Never waits on the writer, if it's still busy the events wait for the next frame
+    LockWriter();
+    if (writeCount == 0)
+    {
+        TraceEvent *events = writeEvents;
+        writeEvents = recordEvents;
+        writeCount = recordCount;
+        recordEvents = events;
+        recordCount = 0;
+        WakeWriter();
+    }
+    UnlockWriter();
+}
+
+#if defined(_WIN32)
+DWORD WINAPI RunTraceWriter(LPVOID unused)
+#else
+void *RunTraceWriter(void *unused)
+#endif
+{
+    (void)unused;
+
+    LockWriter();
+    for (;;)
+    {
+        while (writeCount == 0 && !shouldStop)
+            WaitWriter();
+        if (writeCount == 0 && shouldStop)
+            break;
+
+        // The game thread leaves writeEvents alone until writeCount is back to 0
+        UnlockWriter();
+        WriteTraceEvents(writeEvents, writeCount);
+        fflush(traceFile);
+        LockWriter();
+        writeCount = 0;
+    }
+    UnlockWriter();
+
+    return 0;
+}
+
+void WriteTraceEvents(const TraceEvent *events, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; i++)
+    {
+        const char *name = (events[i].name < traceNameCount)? traceNames[events[i].name] : "?";
+        fprintf(traceFile, ",\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":1}",
+                name, events[i].phase, events[i].timestamp);
+    }
+}
+
+#if defined(_WIN32)
+double GetTraceTime(void)
+{
+    LARGE_INTEGER count;
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart*1e6/timerFrequency;
+}
+
+void LockWriter(void) { EnterCriticalSection(&writerLock); }
+void UnlockWriter(void) { LeaveCriticalSection(&writerLock); }
+void WakeWriter(void) { WakeConditionVariable(&writerWake); }
+void WaitWriter(void) { SleepConditionVariableCS(&writerWake, &writerLock, INFINITE); }
+#else
+double GetTraceTime(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec*1e6 + (double)now.tv_nsec*1e-3;
+}
+
+void LockWriter(void) { pthread_mutex_lock(&writerLock); }
+void UnlockWriter(void) { pthread_mutex_unlock(&writerLock); }
+void WakeWriter(void) { pthread_cond_signal(&writerWake); }
+void WaitWriter(void) { pthread_cond_wait(&writerWake, &writerLock); }
+#endif
+
+#endif // TRACE_ENABLED
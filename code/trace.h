@@ -0,0 +1,46 @@
+// EXPLANATION:
+// Chrome trace-event export of the profiler zones (open in chrome://tracing or Perfetto)
+// - Started with --trace [file] or the ASTEROIDS_TRACE environment variable
+// - The game thread only stores a timestamp per event, a background thread
+//   formats and writes them, so tracing barely changes the frame times
+// - Doesn't include raylib.h, windows.h is needed for the thread on Windows
+
+#ifndef ASTEROIDS_TRACE_HEADER_GUARD
+#define ASTEROIDS_TRACE_HEADER_GUARD
+
+#include <stdbool.h>
+
+// Macros
+// ----------------------------------------------------------------------------
+#define TRACE_DEFAULT_PATH "trace.json"
+#define TRACE_BUFFER_EVENTS 16384 // events the game thread can record while the writer is busy
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+
+typedef enum TracePhase {
+    TRACE_PHASE_BEGIN = 'B',
+    TRACE_PHASE_END = 'E',
+} TracePhase;
+
+typedef struct TraceEvent {
+    double timestamp; // microseconds since the trace started
+    unsigned short name; // index into the names given to StartTrace
+    char phase; // TracePhase
+} TraceEvent;
+
+typedef struct TraceState {
+    bool isRecording;
+    unsigned long long droppedCount; // events lost to a full buffer
+} TraceState;
+
+extern TraceState trace; // global declaration
+
+// Prototypes
+// ----------------------------------------------------------------------------
+bool StartTrace(const char *path, const char *const *names, unsigned int nameCount); // Opens the file and starts the writer thread
+void StopTrace(void); // Writes what's left and closes the file
+void TraceZone(unsigned int name, TracePhase phase); // Record an event, only while recording
+void FlushTrace(void); // Hand the events so far to the writer, once a frame
+
+#endif // ASTEROIDS_TRACE_HEADER_GUARD
@@ -6,10 +6,15 @@
 
 #include "raylib.h"
 #include "raymath.h" // needed for Vector math
+#include <time.h> // for seeding new sessions
 
+#include "allocator.h"
 #include "config.h"
 #include "input.h"
 #include "asteroids.h"
+#include "platform.h"
+#include "render.h"
+#include "rewind.h"
 
 #define ARRAY_SIZE(arr) (sizeof(arr)/sizeof((arr)[0]))
 
@@ -79,7 +84,7 @@ UiButton *InitUiMenuButton(char *text, int fontSize, float textPosX, float textP
 {
     UiButton button = { text, fontSize, false, { textPosX, textPosY }, RAYWHITE };
     menu->buttonCount++;
-    menu->buttons = MemRealloc(menu->buttons, menu->buttonCount*sizeof(UiButton));
+    menu->buttons = GameRealloc(menu->buttons, menu->buttonCount*sizeof(UiButton));
     menu->buttons[menu->buttonCount - 1] = button;
 
     return &menu->buttons[menu->buttonCount - 1];
@@ -98,7 +103,7 @@ UiButton *InitUiMenuButtonRelative(char* text, int fontSize, UiButton *originBut
 void FreeUiState(void)
 {
     for (unsigned int i = 0; i < ARRAY_SIZE(ui.menus); i++)
-        MemFree(ui.menus[i].buttons);
+        GameFree(ui.menus[i].buttons);
 }
 
 void UpdateUiFrame(void)
@@ -108,7 +113,7 @@ void UpdateUiFrame(void)
         if (IsInputActionPressed(INPUT_ACTION_BACK) && ui.currentMenu != UI_MENU_TITLE)
         {
             ChangeUiMenu(UI_MENU_TITLE);
-            PlaySound(game.beeps[BEEP_MENU]);
+            PlayGameBeep(BEEP_MENU);
         }
 
         UiButton *selectedButton = &ui.menus[ui.currentMenu].buttons[ui.selectedId];
@@ -145,7 +150,7 @@ void UpdateUiMenuTraverse(void)
     UiTitleMenuId prevId = ui.selectedId; // used to play beep
 
     // Move cursor via mouse
-    bool mouseMoved = (Vector2Length(GetMouseDelta()) > 0);
+    bool mouseMoved = (Vector2Length(GetInputMouseDelta()) > 0);
     if (mouseMoved || (ui.firstFrame && ui.lastSelectWithMouse))
     {
         Vector2 mousePos = GetScaledMousePosition();
@@ -209,14 +214,14 @@ void UpdateUiMenuTraverse(void)
     }
 
     if (ui.selectedId != prevId && !ui.firstFrame)
-        PlaySound(game.beeps[BEEP_MENU]);
+        PlayGameBeep(BEEP_MENU);
 
     ui.firstFrame = false;
 }
 
 void UpdateUiButtonMouseHover(UiButton *button)
 {
-    bool mouseMoved = (Vector2Length(GetMouseDelta()) > 0);
+    bool mouseMoved = (Vector2Length(GetInputMouseDelta()) > 0);
     if (!mouseMoved) return;
 
     Vector2 mousePos = GetScaledMousePosition();
@@ -224,7 +229,7 @@ void UpdateUiButtonMouseHover(UiButton *button)
     if (IsMouseWithinUiButton(mousePos, button))
     {
         if (!button->mouseHovered)
-            PlaySound(game.beeps[BEEP_MENU]);
+            PlayGameBeep(BEEP_MENU);
         button->mouseHovered = true;
     }
     else
@@ -238,17 +243,17 @@ void UpdateUiButtonSelect(UiButton *button)
     Vector2 mousePos = GetScaledMousePosition();
 
     // Select pause button
-    if (ui.currentMenu == UI_MENU_GAMEPLAY && IsGestureDetected(GESTURE_TAP) &&
-         (!IsMouseButtonPressed(MOUSE_RIGHT_BUTTON) && IsMouseWithinUiButton(mousePos, button)))
+    if (ui.currentMenu == UI_MENU_GAMEPLAY && IsInputTapped() &&
+         (!IsInputMouseButtonPressed(MOUSE_RIGHT_BUTTON) && IsMouseWithinUiButton(mousePos, button)))
     {
         ChangeUiMenu(UI_MENU_PAUSE);
-        PlaySound(game.beeps[BEEP_MENU]);
+        PlayGameBeep(BEEP_MENU);
     }
 
     // Select a menu button
     else if (IsInputActionPressed(INPUT_ACTION_CONFIRM) ||
-        (IsGestureDetected(GESTURE_TAP) &&
-         (!IsMouseButtonPressed(MOUSE_RIGHT_BUTTON) && IsMouseWithinUiButton(mousePos, button))))
+        (IsInputTapped() &&
+         (!IsInputMouseButtonPressed(MOUSE_RIGHT_BUTTON) && IsMouseWithinUiButton(mousePos, button))))
     {
         if (ui.currentMenu == UI_MENU_GAMEPLAY && !game.isPaused)
             return; // not a menu
@@ -274,7 +279,7 @@ void UpdateUiButtonSelect(UiButton *button)
                 ChangeUiMenu(UI_MENU_GAMEPLAY);
         }
 
-        PlaySound(game.beeps[BEEP_MENU]);
+        PlayGameBeep(BEEP_MENU);
     }
 }
 
@@ -299,7 +304,8 @@ void ChangeUiMenu(UiMenuState newMenu)
         if (game.currentScreen == SCREEN_GAMEPLAY)
         {
             FreeGameState();
-            InitGameState();
+            InitGameState((unsigned int)time(0));
+            RebakeStarField(); // new session, new stars
             game.currentScreen = SCREEN_TITLE;
         }
 
@@ -327,8 +333,7 @@ void DrawUiFrame(void)
     if (game.currentScreen == SCREEN_TITLE)
     {
         // Draw stars
-        for (unsigned int i = 0; i < STAR_AMOUNT; i++)
-            DrawCircleV(game.stars[i], 1.0f, WHITE);
+        DrawStarField();
 
         // Draw title menu
         for (unsigned int i = 0; i < ARRAY_SIZE(ui.title); i++)
@@ -370,6 +375,14 @@ void DrawUiFrame(void)
                      VIRTUAL_HEIGHT/2 - SCORE_FONT_SIZE/2,
                      SCORE_FONT_SIZE, fadeColor);
         }
+        else if (rewindBuffer.isRewinding) // Draw rewind message
+        {
+            text = "REWIND";
+            int textOffset = MeasureText(text, SCORE_FONT_SIZE)/2;
+            DrawText(text, VIRTUAL_WIDTH/2 - textOffset,
+                     VIRTUAL_HEIGHT/2 - SCORE_FONT_SIZE/2,
+                     SCORE_FONT_SIZE, fadeColor);
+        }
         else if (game.currentMode == MODE_DEMO) // Draw demo mode message
         {
             text = "DEMO MODE";